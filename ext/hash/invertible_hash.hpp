@@ -9,6 +9,11 @@
   hash_64(): hash_64i(hash_64(x, mask), mask) == hash_64(hash_64i(x, mask), mask) == x.
 */
 
+#ifndef INVERTIBLE_HASH_HPP
+#define INVERTIBLE_HASH_HPP
+
+#include <cstdint>
+
 namespace conn
 {
   namespace graphGen
@@ -66,3 +71,5 @@ namespace conn
       }
   }
 }
+
+#endif
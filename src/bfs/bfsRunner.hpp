@@ -28,10 +28,13 @@
 
 #include <mpi.h>
 #include <iostream>
+#include <cmath>
+#include <cassert>
 #include <unordered_set>
 
 //Own includes
 #include "graphGen/common/reduceIds.hpp"
+#include "graphGen/common/utils.hpp"
 #include "bfs/timer.hpp"
 #include "utils/commonfuncs.hpp"
 
@@ -47,37 +50,66 @@ namespace conn
 {
   namespace bfs
   {
+    /**
+     * @brief     semiring for SpMV over the boolean adjacency matrix, y[u] = min of x[v] over the neighbors v
+     */
+    template <class T2>
+      struct select2ndMinSRing
+      {
+        typedef T2 T_promote;
+        static T_promote id() { return std::numeric_limits<T2>::max(); }
+        static bool returnedSAID() { return false; }
+        static MPI_Op mpi_op() { return MPI_MIN; }
+        static T_promote add(const T_promote & arg1, const T_promote & arg2)
+        {
+          return std::min(arg1, arg2);
+        }
+        static T_promote multiply(const bool & arg1, const T2 & arg2)
+        {
+          return arg2;
+        }
+        static void axpy(bool a, const T2 & x, T_promote & y)
+        {
+          y = std::min(y, x);
+        }
+      };
+
     /**
      * @class                     conn::bfs::bfsSupport
      * @brief                     supports parallel connected component labeling using BFS iterations
      * @tparam[in]  vertexIdType  type used for vertices in the distributed edge list
+     * @tparam[in]  localIdType   type used for the indices within the local block of the matrix and
+     *                            the local vector entries, int32_t halves the matrix index storage
+     *                            if localIdsFit() for the vertex count. Global ids stay vertexIdType
      */
-    template <typename vertexIdType>
+    template <typename vertexIdType, typename localIdType = vertexIdType>
       class bfsSupport
       {
         private:
 
           //BFS implementation uses signed integer types
           static_assert(std::numeric_limits<vertexIdType>::is_signed, "vertexIdType should be a signed type");
+          static_assert(std::numeric_limits<localIdType>::is_signed, "localIdType should be a signed type");
+          static_assert(sizeof(localIdType) <= sizeof(vertexIdType), "localIdType should not be wider than vertexIdType");
           typedef vertexIdType E;
 
-          //Distributed set of unvisited vertices
-          std::unordered_set<E> unVisitedVertices;
+          //Distributed set of unvisited vertices, saved as local ids
+          std::unordered_set<localIdType> unVisitedVertices;
 
           //Reference to the distributed edge list 
           std::vector< std::pair<E, E> > &edgeList;
 
           //Matrix type, to store the adjacency matrix (bool values)
           //from combBLAS implementation 
-          using booleanMatrixType = SpParMat <E, bool, SpDCCols<E ,bool> >;
+          using booleanMatrixType = SpParMat <E, bool, SpDCCols<localIdType ,bool> >;
 
           //Matrix type, to store the adjacency matrix (int values)
           //from combBLAS implementation 
           using integerMatrixType = SpParMat <E, E, SpDCCols<E, E> >;
 
           //Optimization buffer (used as a parameter in combBLAS function calls)
-          //TODO: Generalize these types
-          OptBuf<int32_t, int64_t> optbuf;
+          //Indices exchanged during SpMV are 32-bit in combBLAS, values are the vertex ids
+          OptBuf<int32_t, E> optbuf;
 
           //Record MTEPS score of each iteration
           std::vector<double> MTEPS;
@@ -100,6 +132,21 @@ namespace conn
 
         public:
 
+        /**
+         * @brief                 whether the local blocks of the adjacency matrix can be indexed with
+         *                        localIdType, on the square process grid used by combBLAS
+         * @param[in] vertexCount total count of vertices in the graph
+         */
+        static bool localIdsFit(std::size_t vertexCount, const mxx::comm &comm)
+        {
+          std::size_t gridDim = std::sqrt(comm.size());
+
+          //Last block of a row or column also takes the remainder
+          std::size_t localDim = vertexCount / gridDim + gridDim;
+
+          return localDim < static_cast<std::size_t>(std::numeric_limits<localIdType>::max());
+        }
+
         /**
          * @brief                 constructor, builds the adjacency matrix required for BFS
          * @param[in] edgeList    input graph as distributed edgeList
@@ -107,9 +154,12 @@ namespace conn
          *                        assuming vertex id begins from 0
          * @param[in] comm        mpi communicator
          *                        TODO : Enable the communicator restriction on all the BFS functions
+         * @param[in] storage     halfEdges if each edge is present only once in the edgeList,
+         *                        the adjacency matrix is then symmetrized here
          */
         bfsSupport(std::vector< std::pair<E, E> > &_edgeList, std::size_t vertexCount,
-                  const mxx::comm &_comm) : edgeList(_edgeList), comm(_comm.copy()), A(comm), degrees(comm)
+                  const mxx::comm &_comm,
+                  conn::graphGen::edgeStorage storage = conn::graphGen::edgeStorage::bothWays) : edgeList(_edgeList), comm(_comm.copy()), A(comm), degrees(comm)
         {
           //List of edges, distributed in 1D fashion
           DistEdgeList<E> *DEL = new DistEdgeList<E>();
@@ -124,12 +174,23 @@ namespace conn
 
           comm.barrier();
 
+          //Add the implied reverse edges, A = A + A'
+          if(storage == conn::graphGen::edgeStorage::halfEdges)
+          {
+            integerMatrixType GT(*G);
+            GT.Transpose();
+            *G += GT;
+
+            comm.barrier();
+          }
+
           //Compute the vertex degrees
           G->Reduce(degrees, Row, plus<E>(), static_cast<E>(0));	// Identity is 0 
 
           comm.barrier();
 
-          //Now represent the adj matrix in the boolean format
+          //Now represent the adj matrix in the boolean format, with localIdType indices
+          assert(localIdsFit(vertexCount, comm));
           A =  booleanMatrixType(*G);			// Convert to Boolean
           delete G;
 
@@ -145,7 +206,7 @@ namespace conn
           //Record the local array size
           localDistVecSize = tmp.LocArrSize();
 
-          for(E i = 0; i < tmp.LocArrSize(); i++)
+          for(localIdType i = 0; i < tmp.LocArrSize(); i++)
           {
             //Note that we are saving local id of every vertex
             //This gets convenient when we erase the visited elements later
@@ -165,11 +226,13 @@ namespace conn
          * @param[in]   noIterations          upper bound on the count of iterations for BFS runs
          *                                    it can also return if the graph is completely visited
          * @param[out]  countComponentSizes   vector of count of vertices visited during each BFS run
+         * @param[in]   fromMaxDegree         start each run from an unvisited vertex of maximum degree,
+         *                                    instead of the unvisited vertex with minimum id
          * @details                           Each bfs run begins from unvisited vertex till it traverses
          *                                    that component
          * @return                            number of iterations executed by BFS
          */
-        std::size_t runBFSIterations(std::size_t noIterations, std::vector<std::size_t> &countComponentSizes)
+        std::size_t runBFSIterations(std::size_t noIterations, std::vector<std::size_t> &countComponentSizes, bool fromMaxDegree = false)
         {
           //Execute BFS noIterations times
           for(int i = 0; i < noIterations; i++) 
@@ -181,7 +244,7 @@ namespace conn
             E offsetForLocalToGlobal = mxx::exscan(localDistVecSize, comm);
 
             //Get the source vertex
-            E srcPoint = getSource(offsetForLocalToGlobal);
+            E srcPoint = fromMaxDegree ? getMaxDegreeSource() : getSource(offsetForLocalToGlobal);
 
             LOG_IF(comm.rank() == 0, INFO) << "BFS_DEBUG getSource -> " << srcPoint;
 
@@ -261,6 +324,110 @@ namespace conn
 
         }
 
+        /**
+         * @brief                             labels all the components which were not visited by BFS, using
+         *                                    linear algebraic hooking and shortcutting on the adjacency matrix
+         * @details                           FastSV form of LACC, with dense vectors f (parent) and gf 
+         *                                    (grandparent) over the 2D decomposed matrix. Each iteration does
+         *                                    mngf = A * gf                   SpMV with (select2nd, min) semiring
+         *                                    f[f[u]] = min(f[f[u]], mngf[u])  stochastic hooking, scatter-min through
+         *                                                                    a sparse vector indexed by f
+         *                                    f = min(f, mngf)                aggressive hooking, EWise
+         *                                    f = min(f, gf)                  shortcutting, EWise
+         *                                    gf = f(f)                       subsref
+         *                                    till gf is unchanged. The edgeList is not needed, all the remaining
+         *                                    vertices are marked visited, so filterEdgeList() leaves no edges
+         * @note                              BFS runs cover whole components, so the visited vertices are
+         *                                    masked out of gf and the SpMV only touches the columns of the
+         *                                    residual graph. The visited vertices get no neighbor minimum and
+         *                                    stay settled at their own ids
+         * @return                            count of components among the vertices unvisited by BFS
+         */
+        std::size_t runLinearAlgebraicCC()
+        {
+          E n = A.getncol();
+
+          FullyDistVec<E, E> unVisited = unVisitedIndicator();
+
+          FullyDistVec<E, E> f(A.getcommgrid());
+          f.iota(n, 0);
+
+          //Vertex ids, used later to find the roots
+          FullyDistVec<E, E> ids(f);
+
+          FullyDistVec<E, E> gf(f);
+
+          auto minOp = [](E a, E b){ return std::min(a, b); };
+
+          std::size_t iterCount = 0;
+          E changed = 1;
+
+          while(changed > 0)
+          {
+            //Grandparents of the unvisited vertices only
+            FullyDistVec<E, E> gfMasked(gf);
+            gfMasked.EWiseApply(unVisited, [](E a, E b){ return b ? a : (E) -1; });
+            FullyDistSpVec<E, E> gfResidual = gfMasked.Find(std::bind2nd(std::greater<E>(), (E) -1));
+
+            //Minimum grandparent among the neighbors
+            FullyDistSpVec<E, E> mngfResidual(A.getcommgrid(), n);
+            SpMV<select2ndMinSRing<E>>(A, gfResidual, mngfResidual, false);
+
+            FullyDistVec<E, E> mngf(A.getcommgrid(), n, MAX);
+            mngf.Set(mngfResidual);
+
+            //Stochastic hooking, duplicate parents keep the minimum value
+            FullyDistSpVec<E, E> hooks(n, f, mngf, false);
+            f.EWiseApply(hooks, minOp, false, MAX);
+
+            //Aggressive hooking
+            f.EWiseApply(mngf, minOp);
+
+            //Shortcutting
+            f.EWiseApply(gf, minOp);
+
+            FullyDistVec<E, E> gfNext = f(f);
+
+            FullyDistVec<E, E> diff(gfNext);
+            diff.EWiseApply(gf, [](E a, E b){ return (E) (a != b); });
+            changed = diff.Reduce(plus<E>(), (E) 0);
+
+            gf = gfNext;
+            iterCount++;
+          }
+
+          LOG_IF(comm.rank() == 0, INFO) << "Linear algebraic CC took " << iterCount << " iterations";
+
+          //Roots with at least one edge, among the unvisited vertices
+          FullyDistVec<E, E> roots(f);
+          roots.EWiseApply(ids, [](E a, E b){ return (E) (a == b); });
+          roots.EWiseApply(degrees, [](E a, E b){ return (E) (a && b > 0); });
+          roots.EWiseApply(unVisited, [](E a, E b){ return (E) (a && b); });
+
+          std::size_t componentCount = roots.Reduce(plus<E>(), (E) 0);
+
+          //Every vertex is labeled now
+          unVisitedVertices.clear();
+
+          return componentCount;
+        }
+
+        /**
+         * @brief                             degree summary of the vertices not visited yet, cheap enough
+         *                                    to be evaluated after every BFS run
+         * @param[out]  residualVertices      count of the unvisited vertices with at least one edge
+         * @param[out]  residualDegreeSum     sum of their degrees, i.e. twice the count of remaining edges
+         * @param[out]  maxResidualDegree     maximum degree among them
+         */
+        void residualDegreeSummary(std::size_t &residualVertices, std::size_t &residualDegreeSum, std::size_t &maxResidualDegree)
+        {
+          FullyDistVec<E, E> residualDegrees = unVisitedDegrees();
+
+          residualDegreeSum = residualDegrees.Reduce(plus<E>(), (E) 0);
+          maxResidualDegree = residualDegrees.Reduce(maximum<E>(), (E) 0);
+          residualVertices = residualDegrees.Reduce(plus<E>(), (E) 0, [](E d){ return (E) (d > 0); });
+        }
+
         /**
          * @brief                             Remove the edges corresponding to vertices which have been 
          *                                    covered by BFS
@@ -268,6 +435,8 @@ namespace conn
          *                                    unvisited vertices
          *                                    Do all2all and remove the edges through linear scan
          * @note                              This function should be called after running the BFS iterations. 
+         * @note                              Filtering on SRC alone is also correct for halfEdges storage,
+         *                                    both endpoints of an edge are visited by the same BFS
          */
         void filterEdgeList()
         {
@@ -384,6 +553,49 @@ namespace conn
           E source = mxx::allreduce(firstLocalElement, mxx::min<E>(), comm);
           return source;
         }
+
+        /**
+         * @brief             returns the unvisited vertex with maximum degree (minimum id among ties),
+         *                    likely to belong to the largest component left
+         */
+        E getMaxDegreeSource()
+        {
+          FullyDistVec<E, E> residualDegrees = unVisitedDegrees();
+
+          E maxDegree = residualDegrees.Reduce(maximum<E>(), (E) 0);
+
+          //All vertices visited
+          if(maxDegree == 0)
+            return MAX;
+
+          FullyDistSpVec<E, E> candidates = residualDegrees.Find(std::bind2nd(std::equal_to<E>(), maxDegree));
+          candidates.setNumToInd();
+
+          return candidates.Reduce(minimum<E>(), MAX);
+        }
+
+        /**
+         * @brief             1 for the unvisited vertices, 0 otherwise
+         */
+        FullyDistVec<E, E> unVisitedIndicator()
+        {
+          FullyDistVec<E, E> unVisited(A.getcommgrid(), A.getncol(), (E) 0);
+          for(auto &v : unVisitedVertices)
+            unVisited.SetLocalElement(v, 1);
+
+          return unVisited;
+        }
+
+        /**
+         * @brief             degree of the unvisited vertices, 0 for the visited ones
+         */
+        FullyDistVec<E, E> unVisitedDegrees()
+        {
+          FullyDistVec<E, E> residualDegrees = unVisitedIndicator();
+          residualDegrees.EWiseApply(degrees, [](E a, E b){ return a * b; });
+
+          return residualDegrees;
+        }
       };
 
   }
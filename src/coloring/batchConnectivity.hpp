@@ -0,0 +1,220 @@
+/*
+ * Copyright 2016 Georgia Institute of Technology
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    batchConnectivity.hpp
+ * @ingroup coloring
+ * @brief   Connected components of many graphs in a single ccl run
+ *
+ * Copyright (c) 2016 Georgia Institute of Technology. All Rights Reserved.
+ */
+
+#ifndef BATCH_CONNECTIVITY_HPP
+#define BATCH_CONNECTIVITY_HPP
+
+//Includes
+#include <mpi.h>
+#include <iostream>
+
+//Own includes
+#include "coloring/labelProp.hpp"
+#include "graphGen/common/utils.hpp"
+
+//External includes
+#include "mxx/comm.hpp"
+#include "mxx/reduction.hpp"
+#include "extutils/logging.hpp"
+
+namespace conn
+{
+  namespace coloring
+  {
+
+    /**
+     * @brief     tuple format of each edge in a batch of graphs
+     */
+    enum batchEdgeTIds
+    {
+      graphId,    //graph the edge belongs to, in [0, nGraphs)
+      srcId,      //source vertex id, local to its graph
+      dstId       //destination vertex id, local to its graph
+    };
+
+    /**
+     * @class                     conn::coloring::batchCcl
+     * @brief                     connected components of a batch of graphs using a single ccl run
+     * @tparam[in]  nIdType       type used for node id, 64-bit integer
+     * @details                   Graph id is packed into the high bits of each vertex id, above the bits
+     *                            needed for the largest vertex id of the batch. Graphs share no vertices
+     *                            then, and since the packed ids order by graph id first, ccl treats graph
+     *                            id as the top key layer of its sorts. All graphs go through the same
+     *                            iterations, so the cost of the collectives is paid once per batch
+     *                            instead of once per graph
+     */
+    template<typename nIdType = uint64_t>
+    class batchCcl
+    {
+      public:
+
+        //Type for saving node ids
+        using nodeIdType = nIdType;
+
+      private:
+
+        static_assert(sizeof(nodeIdType) == 8 && std::is_integral<nodeIdType>::value, "64-bit integer ids expected");
+
+        //This is the communicator which participates for computing the components
+        mxx::comm comm;
+
+        //Count of the graphs in the batch
+        std::size_t nGraphs;
+
+        //Bits of the packed id used by the vertex id
+        int vertexBits;
+
+        //Edges with the packed ids, consumed by the ccl constructor
+        std::vector<std::pair<nodeIdType, nodeIdType>> packedEdgeList;
+
+        ccl<nodeIdType> cclInstance;
+
+      public:
+        /**
+         * @brief                   public constructor
+         * @param[in] batchEdgeList distributed vector of <graph id, src, dst> edges, may be cleared after this call
+         * @param[in] nGraphs       count of graphs in the batch
+         * @param[in] c             mpi communicator for the execution
+         * @param[in] storage       use halfEdges if each undirected edge is present only once in batchEdgeList
+         */
+        template <typename E>
+        batchCcl(std::vector<std::tuple<E,E,E>> &batchEdgeList, std::size_t nGraphs, const mxx::comm &c,
+            conn::graphGen::edgeStorage storage = conn::graphGen::edgeStorage::bothWays)
+          : comm(c.copy()), nGraphs(nGraphs), vertexBits(requiredVertexBits(batchEdgeList, c)),
+          packedEdgeList(packEdges(batchEdgeList)),
+          cclInstance(packedEdgeList, c, conn::utils::memPlacement::firstTouch, storage)
+        {
+          std::vector<std::pair<nodeIdType, nodeIdType>>().swap(packedEdgeList);
+        }
+
+        /**
+         * @brief   Compute the connected component labels of all the graphs
+         */
+        void compute()
+        {
+          cclInstance.compute();
+        }
+
+        /**
+         * @brief     count the components in each graph of the batch
+         * @return    vector of size nGraphs, same on all ranks
+         * @note      should be called after computing connected components. Only vertices
+         *            with edges in the batch are seen, isolated vertices of a graph are
+         *            not counted as components
+         */
+        std::vector<std::size_t> computeComponentCounts()
+        {
+          std::vector<std::pair<nodeIdType, nodeIdType>> labels;
+          cclInstance.getVertexLabels(labels);
+
+          //A component is labeled by one of its vertices, count each at that vertex
+          std::vector<std::size_t> counts(nGraphs, 0);
+          for(auto &l : labels)
+            if(std::get<0>(l) == std::get<1>(l))
+              counts[std::get<0>(l) >> vertexBits]++;
+
+          return mxx::allreduce(counts, std::plus<std::size_t>(), comm);
+        }
+
+        /**
+         * @brief                 component label of each vertex
+         * @param[out] labels     <graph id, vertex id, label> tuples, one per vertex of this rank's share,
+         *                        label is the id of a vertex of the same graph
+         * @note                  should be called after computing connected components
+         */
+        template <typename E>
+        void getVertexLabels(std::vector<std::tuple<E,E,E>> &labels)
+        {
+          std::vector<std::pair<nodeIdType, nodeIdType>> packedLabels;
+          cclInstance.getVertexLabels(packedLabels);
+
+          nodeIdType mask = (static_cast<nodeIdType>(1) << vertexBits) - 1;
+
+          labels.clear();
+          labels.reserve(packedLabels.size());
+
+          for(auto &l : packedLabels)
+            labels.emplace_back(std::get<0>(l) >> vertexBits, std::get<0>(l) & mask, std::get<1>(l) & mask);
+        }
+
+      private:
+
+        /**
+         * @brief     count of bits to represent the largest vertex id of the batch
+         */
+        template <typename E>
+        static int requiredVertexBits(const std::vector<std::tuple<E,E,E>> &batchEdgeList, const mxx::comm &comm)
+        {
+          E maxId = 0;
+          for(auto &e : batchEdgeList)
+            maxId = std::max(maxId, std::max(std::get<srcId>(e), std::get<dstId>(e)));
+
+          maxId = mxx::allreduce(maxId, mxx::max<E>(), comm);
+
+          int bits = 1;
+          while(bits < 63 && (static_cast<uint64_t>(maxId) >> bits) > 0)
+            bits++;
+
+          return bits;
+        }
+
+        /**
+         * @brief     builds the edge list of packed ids <graph id | vertex id>
+         */
+        template <typename E>
+        std::vector<std::pair<nodeIdType, nodeIdType>> packEdges(const std::vector<std::tuple<E,E,E>> &batchEdgeList)
+        {
+          int graphBits = 1;
+          while(graphBits < 63 && ((nGraphs - 1) >> graphBits) > 0)
+            graphBits++;
+
+          //Highest ids are reserved by ccl, and the top bit is kept clear for signed types
+          //Same on all ranks, as vertexBits is reduced over the communicator
+          if(vertexBits + graphBits > 62)
+          {
+            if(comm.rank() == 0)
+              std::cerr << "Batch of " << nGraphs << " graphs needs " << vertexBits + graphBits 
+                << " bits for the packed ids, only 62 are available" << std::endl;
+            MPI_Abort(comm, 1);
+          }
+
+          LOG_IF(comm.rank() == 0, INFO) << "Batch of " << nGraphs << " graphs, packed ids use " << vertexBits 
+            << " vertex bits and " << graphBits << " graph bits";
+
+          std::vector<std::pair<nodeIdType, nodeIdType>> edgeList;
+          edgeList.reserve(batchEdgeList.size());
+
+          for(auto &e : batchEdgeList)
+          {
+            nodeIdType g = static_cast<nodeIdType>(std::get<graphId>(e)) << vertexBits;
+            edgeList.emplace_back(g | static_cast<nodeIdType>(std::get<srcId>(e)), g | static_cast<nodeIdType>(std::get<dstId>(e)));
+          }
+
+          return edgeList;
+        }
+    };
+  }
+}
+
+#endif
@@ -0,0 +1,227 @@
+/*
+ * Copyright 2016 Georgia Institute of Technology
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    compressedTuples.hpp
+ * @ingroup coloring
+ * @brief   Compact storage of the stable ccl tuples, till their labels are needed
+ *
+ * Copyright (c) 2016 Georgia Institute of Technology. All Rights Reserved.
+ */
+
+#ifndef COMPRESSED_TUPLES_HPP
+#define COMPRESSED_TUPLES_HPP
+
+//Includes
+#include <vector>
+#include <tuple>
+#include <algorithm>
+#include <cstdint>
+
+//Own includes
+#include "coloring/labelProp_utils.hpp"
+#include "utils/commonfuncs.hpp"
+
+namespace conn
+{
+  namespace coloring
+  {
+
+    /**
+     * @class                 conn::coloring::compressedTupleStore
+     * @brief                 byte stream of stable <Pc, Pn, nId> tuples, Pn is dropped as it is the
+     *                        same for all of them
+     * @details               Tuples are sorted by (Pc, nId) and written as runs of equal Pc
+     *                          Pc delta from the previous run, count of distinct nIds in the run,
+     *                          then for each nId : delta from the previous nId, count of its tuples
+     *                        All the values are varints, the deltas zigzag coded as the runs of
+     *                        different append() calls need not be ordered. A node of degree d in a
+     *                        stable partition takes a few bytes instead of d tuples
+     * @tparam[in]  T         tuple type of ccl
+     */
+    template <typename T>
+      class compressedTupleStore
+      {
+        private:
+
+          using pIdtype = typename std::tuple_element<cclTupleIds::Pc, T>::type;
+          using nodeIdType = typename std::tuple_element<cclTupleIds::nId, T>::type;
+
+          std::vector<uint8_t> stream;
+
+          //Last Pc written, deltas continue from it
+          uint64_t lastPc = 0;
+
+          //Count of tuples stored
+          std::size_t tupleCount = 0;
+
+          void putVarint(uint64_t value)
+          {
+            while(value >= 0x80)
+            {
+              stream.push_back((uint8_t)(value | 0x80));
+              value >>= 7;
+            }
+            stream.push_back((uint8_t) value);
+          }
+
+          void putDelta(uint64_t value, uint64_t previous)
+          {
+            int64_t delta = (int64_t)(value - previous);
+            putVarint(((uint64_t) delta << 1) ^ (uint64_t)(delta >> 63));
+          }
+
+          static uint64_t getVarint(std::vector<uint8_t>::const_iterator &it)
+          {
+            uint64_t value = 0;
+            int shift = 0;
+
+            while(*it & 0x80)
+            {
+              value |= (uint64_t)(*it++ & 0x7f) << shift;
+              shift += 7;
+            }
+            value |= (uint64_t)(*it++) << shift;
+
+            return value;
+          }
+
+          static uint64_t getDelta(std::vector<uint8_t>::const_iterator &it, uint64_t previous)
+          {
+            uint64_t zigzag = getVarint(it);
+            int64_t delta = (int64_t)(zigzag >> 1) ^ -(int64_t)(zigzag & 1);
+
+            return previous + (uint64_t) delta;
+          }
+
+        public:
+
+          /**
+           * @brief       appends the tuples in [first, last), reorders the range
+           */
+          template <typename Iterator>
+            void append(Iterator first, Iterator last)
+            {
+              std::sort(first, last, conn::utils::TpleComp2Layers<cclTupleIds::Pc, cclTupleIds::nId>());
+
+              for(auto it = first; it != last;)
+              {
+                auto pcRange = conn::utils::findRange(it, last, *it, conn::utils::TpleComp<cclTupleIds::Pc>());
+
+                uint64_t pc = std::get<cclTupleIds::Pc>(*it);
+
+                std::size_t distinctNodes = 1;
+                for(auto it2 = pcRange.first + 1; it2 != pcRange.second; it2++)
+                  if(std::get<cclTupleIds::nId>(*it2) != std::get<cclTupleIds::nId>(*(it2 - 1)))
+                    distinctNodes++;
+
+                putDelta(pc, lastPc);
+                putVarint(distinctNodes);
+                lastPc = pc;
+
+                uint64_t lastNode = pc;
+                for(auto it2 = pcRange.first; it2 != pcRange.second;)
+                {
+                  auto nodeRange = conn::utils::findRange(it2, pcRange.second, *it2, conn::utils::TpleComp<cclTupleIds::nId>());
+
+                  uint64_t node = std::get<cclTupleIds::nId>(*it2);
+                  putDelta(node, lastNode);
+                  putVarint(std::distance(nodeRange.first, nodeRange.second));
+                  lastNode = node;
+
+                  it2 = nodeRange.second;
+                }
+
+                tupleCount += std::distance(pcRange.first, pcRange.second);
+                it = pcRange.second;
+              }
+            }
+
+          /**
+           * @brief       calls f(Pc, count of tuples) for each run, without decoding the tuples
+           */
+          template <typename Func>
+            void forEachRun(Func f) const
+            {
+              auto it = stream.cbegin();
+              uint64_t pc = 0;
+
+              while(it != stream.cend())
+              {
+                pc = getDelta(it, pc);
+                std::size_t distinctNodes = getVarint(it);
+
+                std::size_t count = 0;
+                for(std::size_t i = 0; i < distinctNodes; i++)
+                {
+                  getVarint(it);
+                  count += getVarint(it);
+                }
+
+                f(static_cast<pIdtype>(pc), count);
+              }
+            }
+
+          /**
+           * @brief       appends the stored tuples to the vector with the given Pn, and empties the store
+           */
+          void decode(std::vector<T> &tuples, pIdtype pn)
+          {
+            tuples.reserve(tuples.size() + tupleCount);
+
+            auto it = stream.cbegin();
+            uint64_t pc = 0;
+
+            while(it != stream.cend())
+            {
+              pc = getDelta(it, pc);
+              std::size_t distinctNodes = getVarint(it);
+
+              uint64_t node = pc;
+              for(std::size_t i = 0; i < distinctNodes; i++)
+              {
+                node = getDelta(it, node);
+                std::size_t count = getVarint(it);
+
+                for(std::size_t j = 0; j < count; j++)
+                  tuples.emplace_back(static_cast<pIdtype>(pc), pn, static_cast<nodeIdType>(node));
+              }
+            }
+
+            clear();
+          }
+
+          void clear()
+          {
+            std::vector<uint8_t>().swap(stream);
+            lastPc = 0;
+            tupleCount = 0;
+          }
+
+          std::size_t size() const
+          {
+            return tupleCount;
+          }
+
+          std::size_t bytes() const
+          {
+            return stream.size();
+          }
+      };
+  }
+}
+
+#endif
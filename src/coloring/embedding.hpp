@@ -0,0 +1,155 @@
+/*
+ * Copyright 2016 Georgia Institute of Technology
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    embedding.hpp
+ * @ingroup coloring
+ * @brief   Connected components over edge arrays owned by the caller, for embedding the library
+ *
+ * Copyright (c) 2016 Georgia Institute of Technology. All Rights Reserved.
+ */
+
+#ifndef CONN_EMBEDDING_HPP
+#define CONN_EMBEDDING_HPP
+
+//Includes
+#include <mpi.h>
+#include <vector>
+#include <algorithm>
+
+//Own includes
+#include "coloring/labelProp.hpp"
+
+//External includes
+#include "mxx/comm.hpp"
+#include "mxx/reduction.hpp"
+
+namespace conn
+{
+  namespace coloring
+  {
+
+    /**
+     * @class     conn::coloring::edgeSpanSource
+     * @brief     Edge generator (see the generator constructor of ccl) over the caller's arrays,
+     *            edge i is (src[i * stride], dst[i * stride])
+     */
+    template <typename E>
+      class edgeSpanSource
+      {
+        private:
+
+          const E *src, *dst;
+          std::size_t count, stride;
+
+          //Next edge to read, and the count of edges per chunk
+          std::size_t position = 0;
+          std::size_t chunkEdges;
+
+        public:
+
+          using edgeType = E;
+
+          edgeSpanSource(const E *src, const E *dst, std::size_t count, std::size_t stride = 1, std::size_t chunkEdges = 1UL << 16)
+            : src(src), dst(dst), count(count), stride(stride), chunkEdges(chunkEdges) {}
+
+          std::size_t sizeHint() const
+          {
+            return count;
+          }
+
+          bool next(std::vector< std::pair<E, E> > &chunk)
+          {
+            chunk.clear();
+
+            if(position == count)
+              return false;
+
+            std::size_t last = std::min(count, position + chunkEdges);
+
+            for(std::size_t i = position; i < last; i++)
+              chunk.emplace_back(src[i * stride], dst[i * stride]);
+
+            position = last;
+
+            return true;
+          }
+      };
+
+    /**
+     * @brief                 connected components of the edges in the caller's arrays, which are
+     *                        read in place, never copied into an edge list
+     * @param[in] src         sources of this rank's edges, count values stride apart
+     * @param[in] dst         destinations, same layout
+     * @param[in] stride      1 for separate columns, 2 for interleaved <src, dst> pairs
+     * @param[out] labels     count values, the component label of each edge, or nullptr if only the count
+     *                        is needed. A label is the id of one of the component's vertices
+     * @param[in] comm        MPI communicator, all its ranks call together
+     * @return                global count of the components
+     * @details               An undirected edge may be listed once or in both directions. Memory of the
+     *                        run is the ccl tuples, one per edge and per source vertex (half-edge mode),
+     *                        and the labels of the vertices while the edge labels are looked up
+     */
+    template <typename E>
+      std::size_t computeComponents(const E *src, const E *dst, std::size_t count, std::size_t stride, E *labels, MPI_Comm comm)
+      {
+        mxx::comm c(comm);
+
+        std::vector<std::pair<E, E>> vertexLabels;
+        std::size_t componentCount = 0;
+
+        c.with_subset(count > 0, [&](const mxx::comm& c){
+            edgeSpanSource<E> source(src, dst, count, stride);
+
+            ccl<E> cclInstance(source, c, conn::utils::memPlacement::firstTouch, conn::graphGen::edgeStorage::halfEdges);
+            cclInstance.compute();
+
+            componentCount = cclInstance.computeComponentCount();
+
+            if(labels != nullptr)
+              cclInstance.getVertexLabels(vertexLabels);
+            });
+
+        componentCount = mxx::allreduce(componentCount, mxx::max<std::size_t>(), c);
+
+        if(mxx::allreduce((int) (labels != nullptr), mxx::max<int>(), c))
+          lookupVertexLabels(vertexLabels, src, labels != nullptr ? count : 0, stride, labels, c);
+
+        return componentCount;
+      }
+
+    /**
+     * @brief     separate src[] and dst[] columns
+     */
+    template <typename E>
+      std::size_t computeComponents(const E *src, const E *dst, std::size_t count, E *labels, MPI_Comm comm)
+      {
+        return computeComponents(src, dst, count, 1, labels, comm);
+      }
+
+    /**
+     * @brief     interleaved edges, edges[2i] and edges[2i+1] are the endpoints of edge i
+     */
+    template <typename E>
+      std::size_t computeComponents(const E *edges, std::size_t count, E *labels, MPI_Comm comm)
+      {
+        return computeComponents(edges, edges + 1, count, 2, labels, comm);
+      }
+
+  }
+}
+
+#endif
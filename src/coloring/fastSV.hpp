@@ -0,0 +1,245 @@
+/*
+ * Copyright 2016 Georgia Institute of Technology
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    fastSV.hpp
+ * @ingroup coloring
+ * @brief   Connected components using distributed Shiloach-Vishkin style hooking and
+ *          shortcutting (FastSV variant), an alternative engine to ccl
+ *
+ * Copyright (c) 2016 Georgia Institute of Technology. All Rights Reserved.
+ */
+
+#ifndef FAST_SV_HPP
+#define FAST_SV_HPP
+
+//Includes
+#include <mpi.h>
+#include <iostream>
+#include <algorithm>
+#include <numeric>
+
+//Own includes
+#include "utils/commonfuncs.hpp"
+#include "utils/distArray.hpp"
+#include "graphGen/common/utils.hpp"
+#include "graphGen/common/reorderIds.hpp"
+
+//External includes
+#include "mxx/comm.hpp"
+#include "mxx/partition.hpp"
+#include "mxx/reduction.hpp"
+#include "extutils/logging.hpp"
+
+namespace conn
+{
+  namespace coloring
+  {
+
+    /**
+     * @class                     conn::coloring::fastSV
+     * @brief                     connected components using hook and compress over a distributed parent array
+     * @tparam[in]  nIdType       type used for node id
+     * @details                   Vertex ids must be contiguous in [0, nVertices) (see reduceVertexIds).
+     *                            The parent array f and grandparent array gf are split across the ranks in
+     *                            contiguous ranges (block decomposed, or the ranges of partitionVertices()),
+     *                            edges live on the owner of their source. Each iteration does
+     *                            1. stochastic hooking    f[f[u]] = min(f[f[u]], gf[v]) for each edge (u,v)
+     *                            2. aggressive hooking    f[u] = min(f[u], gf[v])
+     *                            3. shortcutting          f[u] = min(f[u], gf[u])
+     *                            and stops when gf = f[f] no longer changes. Parent lookups and hooks
+     *                            to remote parents use owner routed all2all (see utils/distArray.hpp)
+     */
+    template<typename nIdType = uint64_t>
+    class fastSV
+    {
+      public:
+
+        //Type for saving node ids
+        using nodeIdType = nIdType;
+
+      private:
+
+        //This is the communicator which participates for computing the components
+        mxx::comm comm;
+
+        //Count of the vertices, ids are in [0, nVertices)
+        std::size_t nVertices;
+
+        //Range of the vertex ids owned by each rank
+        conn::utils::rangePartition part;
+
+        //Symmetric edges on the owner of their source, sorted by source
+        std::vector<std::pair<nodeIdType, nodeIdType>> adjacency;
+
+        //Unique destination vertices of adjacency
+        std::vector<nodeIdType> neighbors;
+
+        //Parent and grandparent of each local vertex
+        std::vector<nodeIdType> f, gf;
+
+        //Local vertices which have at least one edge
+        std::vector<bool> active;
+
+        std::size_t iterCount = 0;
+
+      public:
+        /**
+         * @brief                 public constructor
+         * @param[in] edgeList    distributed vector of edges, ids in [0, nVertices)
+         * @param[in] nVertices   count of vertices
+         * @param[in] c           mpi communicator for the execution
+         * @param[in] storage     use halfEdges if each undirected edge is present only once in edgeList
+         * @param[in] vertexRanges  count of the vertex ids owned by each rank, as returned by partitionVertices(),
+         *                          the ids are block decomposed if empty
+         */
+        template <typename E>
+        fastSV(std::vector<std::pair<E,E>> &edgeList, std::size_t nVertices, const mxx::comm &c,
+            conn::graphGen::edgeStorage storage = conn::graphGen::edgeStorage::bothWays,
+            const std::vector<std::size_t> &vertexRanges = std::vector<std::size_t>())
+          : comm(c.copy()), nVertices(nVertices),
+          part(vertexRanges.empty() ? conn::utils::rangePartition(nVertices, c) : conn::utils::rangePartition(vertexRanges, c))
+        {
+          //nodeIdType and E should match
+          static_assert(std::is_same<E, nodeIdType>::value, "types must match");
+
+          const int SRC = 0;
+
+          adjacency = conn::graphGen::ownerAdjacency(edgeList, part, comm, storage);
+          neighbors = conn::graphGen::uniqueNeighbors(adjacency);
+
+          std::size_t offset = part.excl_prefix_size();
+
+          f.resize(part.local_size());
+          std::iota(f.begin(), f.end(), offset);
+          gf = f;
+
+          active.assign(part.local_size(), false);
+          for(auto &e : adjacency)
+            active[std::get<SRC>(e) - offset] = true;
+        }
+
+        /**
+         * @brief   Compute the connected component labels
+         */
+        void compute()
+        {
+          const int SRC = 0, DEST = 1;
+
+          std::size_t offset = part.excl_prefix_size();
+          bool converged = false;
+
+          while(!converged)
+          {
+            LOG_IF(comm.rank() == 0, INFO) << "Iteration #" << iterCount + 1;
+
+            std::vector<nodeIdType> fNext(f);
+
+            auto gfNeighbors = conn::utils::blockLookup(neighbors, gf, part, comm);
+
+            //Hooks to the parents, which may be owned by other ranks
+            std::vector<std::pair<nodeIdType, nodeIdType>> hooks;
+
+            for(auto it = adjacency.begin(); it != adjacency.end();)
+            {
+              auto range = conn::utils::findRange(it, adjacency.end(), *it, conn::utils::TpleComp<SRC>());
+              std::size_t u = std::get<SRC>(*it) - offset;
+
+              //Minimum grandparent among the neighbors
+              nodeIdType minGf = std::numeric_limits<nodeIdType>::max();
+              std::for_each(range.first, range.second, [&](const std::pair<nodeIdType, nodeIdType> &e){
+                  auto pos = std::lower_bound(neighbors.begin(), neighbors.end(), std::get<DEST>(e));
+                  minGf = std::min(minGf, gfNeighbors[std::distance(neighbors.begin(), pos)]);
+                  });
+
+              //Stochastic hooking
+              if(minGf < f[u])
+                hooks.emplace_back(f[u], minGf);
+
+              //Aggressive hooking
+              fNext[u] = std::min(fNext[u], minGf);
+
+              it = range.second;
+            }
+
+            //Keep the smallest hook to each parent
+            std::sort(hooks.begin(), hooks.end());
+            hooks.erase(std::unique(hooks.begin(), hooks.end(), conn::utils::TpleComp<0, std::equal_to>()), hooks.end());
+
+            conn::utils::blockReduce(hooks, fNext, part, [](nodeIdType a, nodeIdType b){ return std::min(a, b); }, comm);
+
+            //Shortcutting
+            for(std::size_t i = 0; i < fNext.size(); i++)
+              fNext[i] = std::min(fNext[i], gf[i]);
+
+            f.swap(fNext);
+
+            //Recompute the grandparents
+            std::vector<nodeIdType> parents(f);
+            std::sort(parents.begin(), parents.end());
+            parents.erase(std::unique(parents.begin(), parents.end()), parents.end());
+
+            auto grandParents = conn::utils::blockLookup(parents, f, part, comm);
+
+            int changed = 0;
+            for(std::size_t i = 0; i < f.size(); i++)
+            {
+              auto pos = std::lower_bound(parents.begin(), parents.end(), f[i]);
+              nodeIdType newGf = grandParents[std::distance(parents.begin(), pos)];
+
+              if(newGf != gf[i])
+              {
+                gf[i] = newGf;
+                changed = 1;
+              }
+            }
+
+            converged = (mxx::allreduce(changed, mxx::max<int>(), comm) == 0);
+
+            iterCount++;
+          }
+
+          LOG_IF(comm.rank() == 0, INFO) << "Algorithm took " << iterCount << " iterations";
+        }
+
+        /**
+         * @brief     count the components in the graph, i.e. the roots among the vertices with edges
+         * @note      should be called after computing connected components.
+         */
+        std::size_t computeComponentCount()
+        {
+          std::size_t offset = part.excl_prefix_size();
+          std::size_t localRoots = 0;
+
+          for(std::size_t i = 0; i < f.size(); i++)
+            if(active[i] && f[i] == offset + i)
+              localRoots++;
+
+          return mxx::allreduce(localRoots, std::plus<std::size_t>(), comm);
+        }
+
+        /**
+         * @brief     count of hook and compress iterations executed
+         */
+        std::size_t getIterationCount() const
+        {
+          return iterCount;
+        }
+    };
+  }
+}
+
+#endif
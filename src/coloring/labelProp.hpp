@@ -28,16 +28,28 @@
 
 //Includes
 #include <iostream>
+#include <numeric>
+#include <limits>
+#include <cassert>
 
 //Own includes
 #include "coloring/labelProp_utils.hpp"
 #include "coloring/timer.hpp" //Timer switch 
+#include "coloring/compressedTuples.hpp"
 #include "utils/commonfuncs.hpp"
+#include "utils/memPlacement.hpp"
+#include "utils/hyperLogLog.hpp"
+#include "utils/boundedSort.hpp"
+#include "graphGen/common/utils.hpp"
+#include "hash/invertible_hash.hpp"
 
 //external includes
 #include "mxx/sort.hpp"
 #include "mxx_extra/sort.hpp"
+#include "mxx/shift.hpp"
 #include "mxx/comm.hpp"
+#include "mxx/collective.hpp"
+#include "mxx/partition.hpp"
 #include "extutils/logging.hpp"
 
 namespace conn 
@@ -45,14 +57,84 @@ namespace conn
   namespace coloring
   {
 
+    /**
+     * @brief                 writes the label of each of the count vertices (stride apart), looked up in
+     *                        the distributed <vertex, label> pairs sorted by vertex, see ccl::getVertexLabels
+     * @details               Rounds of at most chunkSize vertices per rank, so the buffers stay small.
+     *                        Each rank sends its vertices to the ranks holding their labels, and places
+     *                        the answers at the positions of the vertices
+     */
+    template <typename E>
+      void lookupVertexLabels(const std::vector<std::pair<E, E>> &vertexLabels, const E *vertices, std::size_t count,
+          std::size_t stride, E *labels, const mxx::comm &comm, std::size_t chunkSize = 1UL << 20)
+      {
+        int p = comm.size();
+
+        //First vertex of each rank, empty ranks take the start of the next one
+        E firstVertex = vertexLabels.empty() ? std::numeric_limits<E>::max() : vertexLabels.front().first;
+        auto starts = mxx::allgather(firstVertex, comm);
+
+        for(int r = p - 2; r >= 0; r--)
+          if(starts[r] == std::numeric_limits<E>::max())
+            starts[r] = starts[r+1];
+
+        auto owner = [&](E vertex) {
+          return (int) (std::upper_bound(starts.begin() + 1, starts.end(), vertex) - starts.begin()) - 1;
+        };
+
+        std::size_t localRounds = (count + chunkSize - 1) / chunkSize;
+        std::size_t rounds = mxx::allreduce(localRounds, mxx::max<std::size_t>(), comm);
+
+        for(std::size_t round = 0; round < rounds; round++)
+        {
+          std::size_t first = std::min(count, round * chunkSize);
+          std::size_t last = std::min(count, first + chunkSize);
+
+          //Queries grouped by their owner rank, in the order of the vertices
+          std::vector<std::size_t> sendCounts(p, 0);
+          for(std::size_t i = first; i < last; i++)
+            sendCounts[owner(vertices[i * stride])]++;
+
+          std::vector<std::size_t> offsets(p, 0);
+          std::partial_sum(sendCounts.begin(), sendCounts.end() - 1, offsets.begin() + 1);
+
+          std::vector<E> queries(last - first);
+          for(std::size_t i = first; i < last; i++)
+            queries[offsets[owner(vertices[i * stride])]++] = vertices[i * stride];
+
+          auto recvCounts = mxx::all2all(sendCounts, comm);
+          auto received = mxx::all2allv(queries, sendCounts, recvCounts, comm);
+
+          for(auto &vertex : received)
+          {
+            auto it = std::lower_bound(vertexLabels.begin(), vertexLabels.end(), std::make_pair(vertex, std::numeric_limits<E>::min()));
+            assert(it != vertexLabels.end() && it->first == vertex);
+
+            vertex = it->second;
+          }
+
+          auto answers = mxx::all2allv(received, recvCounts, sendCounts, comm);
+
+          //Answers come back in the order of the queries
+          std::fill(offsets.begin(), offsets.end(), 0);
+          std::partial_sum(sendCounts.begin(), sendCounts.end() - 1, offsets.begin() + 1);
+
+          for(std::size_t i = first; i < last; i++)
+            labels[i] = answers[offsets[owner(vertices[i * stride])]++];
+        }
+      }
+
     /**
      * @class                     conn::coloring::ccl
      * @brief                     supports parallel connected component labeling using label propagation technique
      * @tparam[in]  nIdType       type used for node id
      * @tparam[in]  DOUBLING      controls whether pointer doubling would be executed or not, 'ON' by default.
-     * @tparam[in]  OPTIMIZATION  optimization level for benchmarking, use loadbalanced for the best version 
+     * @tparam[in]  OPTIMIZATION  optimization level for benchmarking, use loadbalanced for the best version,
+     *                            boundary_active_set additionally keeps only the boundary nodes in the sorts
+     * @tparam[in]  RELAXATION    controls whether labels are propagated to a local fixpoint on each rank 
+     *                            during every iteration, 'OFF' by default
      */
-    template<typename nIdType = uint64_t, uint8_t DOUBLING = lever::ON, uint8_t OPTIMIZATION = opt_level::loadbalanced>
+    template<typename nIdType = uint64_t, uint8_t DOUBLING = lever::ON, uint8_t OPTIMIZATION = opt_level::loadbalanced, uint8_t RELAXATION = lever::OFF>
     class ccl 
     {
       public:
@@ -83,14 +165,74 @@ namespace conn
         //Used to mark the special tuples used during doubling
         nodeIdType MAX_NID = std::numeric_limits<nodeIdType>::max();
 
+        //NUMA and huge page policy for tupleVector
+        conn::utils::memPlacement placement;
+
+        //Buffer of tupleVector the policy was last applied to
+        const T *placedBuffer = nullptr;
+        std::size_t placedCapacity = 0;
+
+        //Whether the input edgeList had both directions of each edge
+        conn::graphGen::edgeStorage storage;
+
+        //Priority of the labels during propagation
+        labelPriority priority;
+
+        //Count of the components, accumulated as the partitions stabilize (opt_level >= stable_partition_removed)
+        std::size_t stableComponentCount = 0;
+
+        //<Pc, contains the node Pc> of the stable partitions split across the rank boundaries
+        std::vector<std::pair<pIdtype, uint8_t>> stableBoundaryPieces;
+
+        //<Pc, local size> of all the stable partitions
+        std::vector<std::pair<pIdtype, std::size_t>> stablePartitionSizes;
+
+        //With opt_level >= loadbalanced, active tuples are redistributed only when their max/mean count exceeds this
+        double rebalanceThreshold = 1.1;
+
+        //Extra memory in bytes allowed to each sort, 0 uses the regular mxx::sort
+        std::size_t sortMemoryBudget = 0;
+
+        //Whether the stable tuples are moved into stableStore, with opt_level >= stable_partition_removed
+        bool compressStable = false;
+
+        //Stable tuples, compressed till they are needed again
+        compressedTupleStore<T> stableStore;
+
+        //Count of the redistributions done, for the log
+        std::size_t rebalanceCount = 0;
+
+        //Largest stable partition piece on this rank, and largest active one in the latest iteration
+        std::size_t largestStablePiece = 0;
+        std::size_t largestActivePiece = 0;
+
+        //Stop after these many iterations, 0 runs to convergence
+        std::size_t iterationLimit = 0;
+
+        //Whether the component statistics are estimated and logged after each iteration
+        bool progressEstimates = false;
+
+        //Redundant tuples of the interior nodes, set aside until the final labeling (opt_level::boundary_active_set)
+        std::vector<T> interiorTuples;
+
+        //Vertex of each self tuple, with halfEdges storage, to count the edges of the components
+        std::vector<nodeIdType> selfTupleSources;
+
       public:
         /**
          * @brief                 public constructor
          * @param[in] edgeList    distributed vector of edges
          * @param[in] c           mpi communicator for the execution 
+         * @param[in] placement   memory placement policy for the tuple array
+         * @param[in] storage     use halfEdges if each undirected edge is present only once in edgeList
+         * @param[in] priority    randomHash propagates the minimum hashed id instead of the minimum id,
+         *                        labels are translated back to vertex ids after compute()
          */
         template <typename E>
-        ccl(std::vector<std::pair<E,E>> &edgeList, const mxx::comm &c) : comm(c.copy()) 
+        ccl(std::vector<std::pair<E,E>> &edgeList, const mxx::comm &c,
+            conn::utils::memPlacement placement = conn::utils::memPlacement::firstTouch,
+            conn::graphGen::edgeStorage storage = conn::graphGen::edgeStorage::bothWays,
+            labelPriority priority = labelPriority::vertexId) : comm(c.copy()), placement(placement), storage(storage), priority(priority)
         {
           //nodeIdType and E should match
           //If they don't, modify the class type or the edgeList type
@@ -99,8 +241,30 @@ namespace conn
           //Parse the edgeList
           convertEdgeListforCCL(edgeList);
 
-          //Re-distribute the tuples uniformly across the ranks
-          mxx::distribute_inplace(tupleVector, comm);
+          prepareTuples();
+        }
+
+        /**
+         * @brief                 constructor over an edge generator, the edge list is never materialized
+         * @param[in] source      generator of the local edges, with
+         *                          edgeType      type of the vertex ids
+         *                          sizeHint()    expected count of the local edges, to reserve the tuples
+         *                          next(chunk)   refills chunk with the next edges, false once exhausted
+         *                        see conn::graphGen::UndirectedChainSource
+         * @details               Other parameters are the same as the edge list constructor
+         */
+        template <typename Generator, typename = typename Generator::edgeType>
+        ccl(Generator &source, const mxx::comm &c,
+            conn::utils::memPlacement placement = conn::utils::memPlacement::firstTouch,
+            conn::graphGen::edgeStorage storage = conn::graphGen::edgeStorage::bothWays,
+            labelPriority priority = labelPriority::vertexId) : comm(c.copy()), placement(placement), storage(storage), priority(priority)
+        {
+          static_assert(std::is_same<typename Generator::edgeType, nodeIdType>::value, "types must match");
+
+          //Pull the edges in chunks
+          convertEdgeSourceforCCL(source);
+
+          prepareTuples();
         }
 
         /**
@@ -115,6 +279,95 @@ namespace conn
           runConnectedComponentLabeling();
         }
 
+        /**
+         * @brief     keep the stable tuples compressed, the memory goes to the active tuples
+         * @note      effective with opt_level >= stable_partition_removed, where the stable partitions are
+         *            set aside. The tuples are decoded when the labels are asked for
+         */
+        void setStableCompression(bool enable)
+        {
+          compressStable = enable;
+        }
+
+        /**
+         * @brief     sort within the given extra memory (bytes per rank), see conn::utils::boundedMemorySort()
+         * @note      useful when the tuples take more than half the memory, mxx::sort needs as much again.
+         *            0 restores mxx::sort
+         */
+        void setSortMemoryBudget(std::size_t budget)
+        {
+          sortMemoryBudget = budget;
+        }
+
+        /**
+         * @brief     set the max/mean imbalance of the active tuples above which they are redistributed
+         * @note      only used with opt_level >= loadbalanced, 1.0 redistributes whenever the load is uneven
+         */
+        void setRebalanceThreshold(double threshold)
+        {
+          rebalanceThreshold = threshold;
+        }
+
+        /**
+         * @brief     stop the computation after the given count of iterations, even if not converged
+         * @note      with an early stop, the labels are partial, use estimateComponentStatistics()
+         *            instead of the exact counts
+         */
+        void setIterationLimit(std::size_t limit)
+        {
+          iterationLimit = limit;
+        }
+
+        /**
+         * @brief     log the estimates of estimateComponentStatistics() after each iteration
+         */
+        void setProgressEstimates(bool enable)
+        {
+          progressEstimates = enable;
+        }
+
+        /**
+         * @brief                     bounds on the component count and the largest component, valid at any iteration
+         * @param[out] lowerBound     components completed so far, plus one if tuples are still active
+         * @param[out] upperBound     distinct partition ids, estimated with a HyperLogLog sketch and padded by
+         *                            three standard errors. Every component holds at least one partition
+         * @param[out] largestFraction  largest partition piece seen, as a fraction of the tuples (~ edges).
+         *                            A partition lies within one component, so this is a lower estimate
+         * @note                      collective, exact bounds need convergence and opt_level >= stable_partition_removed
+         */
+        void estimateComponentStatistics(std::size_t &lowerBound, std::size_t &upperBound, double &largestFraction)
+        {
+          conn::utils::hyperLogLog sketch;
+
+          for(auto &e : tupleVector)
+            if(std::get<cclTupleIds::Pc>(e) != MAX_PID)
+              sketch.insert(static_cast<uint64_t>(std::get<cclTupleIds::Pc>(e)));
+
+          stableStore.forEachRun([&](pIdtype pc, std::size_t count){
+              sketch.insert(static_cast<uint64_t>(pc));
+              });
+
+          sketch.merge(comm);
+
+          double distinctPartitions = sketch.estimate();
+          upperBound = std::ceil(distinctPartitions * (1.0 + 3 * sketch.relativeError()));
+
+          //Active tuples are those which are not part of a stable partition
+          std::size_t localActive = std::count_if(tupleVector.begin(), tupleVector.end(), [&](const T &e){
+              return std::get<cclTupleIds::Pn>(e) != MAX_PID;
+              });
+          std::size_t activeTuples = mxx::allreduce(localActive, std::plus<std::size_t>(), comm);
+
+          lowerBound = (OPTIMIZATION >= opt_level::stable_partition_removed ? countStableComponents() : 0) + (activeTuples > 0 ? 1 : 0);
+          upperBound = std::max(upperBound, lowerBound);
+
+          std::size_t localTuples = tupleVector.size() + interiorTuples.size() + stableStore.size();
+          std::size_t totalTuples = mxx::allreduce(localTuples, std::plus<std::size_t>(), comm);
+          std::size_t largestPiece = mxx::allreduce(std::max(largestStablePiece, largestActivePiece), mxx::max<std::size_t>(), comm);
+
+          largestFraction = totalTuples > 0 ? (double) largestPiece / totalTuples : 0.0;
+        }
+
         /**
          * @brief     count the components in the graph after ccl (useful for debugging/testing)
          * @note      should be called after computing connected components. 
@@ -123,11 +376,17 @@ namespace conn
         {
           std::size_t componentCount;
 
+          //Components were counted when their partitions stabilized
+          if(OPTIMIZATION >= opt_level::stable_partition_removed)
+            return countStableComponents();
+
+          decodeStableTuples();
+
           //Vector should be sorted by Pc
           comm.with_subset(tupleVector.begin() !=  tupleVector.end() , [&](const mxx::comm& comm){
 
             if(!mxx::is_sorted(tupleVector.begin(), tupleVector.end(), conn::utils::TpleComp<cclTupleIds::Pc>(), comm))
-              mxx::sort(tupleVector.begin(), tupleVector.end(), conn::utils::TpleComp<cclTupleIds::Pc>(), comm);
+              sortTuples(tupleVector.begin(), tupleVector.end(), conn::utils::TpleComp<cclTupleIds::Pc>(), comm);
 
             //Count unique Pc values
             componentCount =  mxx::uniqueCount(tupleVector.begin(), tupleVector.end(),  conn::utils::TpleComp<cclTupleIds::Pc>(), comm);
@@ -138,93 +397,151 @@ namespace conn
           return componentCount;
         }
 
+        /**
+         * @brief                 component label of each vertex
+         * @param[out] labels     <vertex id, label> pairs, one per vertex, globally sorted by vertex id
+         * @note                  should be called after computing connected components. Label of a 
+         *                        component is the id of one of its vertices
+         */
+        void getVertexLabels(std::vector<std::pair<nodeIdType, pIdtype>> &labels)
+        {
+          decodeStableTuples();
+
+          labels.clear();
+          labels.reserve(tupleVector.size());
+
+          for(auto &e : tupleVector)
+            labels.emplace_back(std::get<cclTupleIds::nId>(e), std::get<cclTupleIds::Pc>(e));
+
+          comm.with_subset(labels.size() > 0, [&](const mxx::comm& comm){
+
+              sortTuples(labels.begin(), labels.end(), conn::utils::TpleComp<0>(), comm);
+
+              //All tuples of a vertex carry the same label
+              labels.erase(std::unique(labels.begin(), labels.end(), conn::utils::TpleComp<0, std::equal_to>()), labels.end());
+
+              //Vertex continued from the previous rank
+              nodeIdType prevVertex = mxx::right_shift(std::get<0>(labels.back()), comm);
+              if(comm.rank() > 0 && prevVertex == std::get<0>(labels.front()))
+                labels.erase(labels.begin());
+          });
+        }
+
         /**
          * @brief     compute the largest count of component in terms of edges (useful for graph statistics)
          * @note      should be called after computing connected components. 
          * @note      Largest is computed ONLY among the components computed through coloring
+         * @details   Tuples are counted per component, on the rank Pc hashes to. An edge is two tuples
+         *            with bothWays storage, and one with halfEdges, where the self tuples are subtracted
          */
         std::size_t computeLargestComponentSize()
         {
           using E = pIdtype;
 
-          std::size_t largestComponentSize = 0;
+          decodeStableTuples();
 
-          comm.with_subset(tupleVector.begin() !=  tupleVector.end() , [&](const mxx::comm& comm){
+          //<Pc, count of tuples, count of self tuples> of the partition pieces on this rank
+          std::vector<std::tuple<E, std::size_t, std::size_t>> pieces;
 
-              //Vector should be sorted by Pc
-            if(!mxx::is_sorted(tupleVector.begin(), tupleVector.end(), conn::utils::TpleComp<cclTupleIds::Pc>(), comm))
-              mxx::sort(tupleVector.begin(), tupleVector.end(), conn::utils::TpleComp<cclTupleIds::Pc>(), comm);
+          //Sizes were recorded when the partitions stabilized
+          //Not available with boundary_active_set, the stable partitions miss their interior tuples then
+          if(OPTIMIZATION == opt_level::stable_partition_removed || OPTIMIZATION == opt_level::loadbalanced)
+          {
+            for(auto &e : stablePartitionSizes)
+              pieces.emplace_back(std::get<0>(e), std::get<1>(e), 0);
+          }
+          else
+          {
+            comm.with_subset(tupleVector.begin() !=  tupleVector.end() , [&](const mxx::comm& comm){
 
-              std::vector<std::pair<E,E>> partitionSizeVector;
+                //Vector should be sorted by Pc
+                if(!mxx::is_sorted(tupleVector.begin(), tupleVector.end(), conn::utils::TpleComp<cclTupleIds::Pc>(), comm))
+                  sortTuples(tupleVector.begin(), tupleVector.end(), conn::utils::TpleComp<cclTupleIds::Pc>(), comm);
+                });
 
-              std::pair<E,E> firstPc(0,0);      //Component that touches the left boundary
-              std::pair<E,E> middlePc (0,0);    //Internal partition in this rank (not at the boundaries)
-              std::pair<E,E> lastPc(0,0);
+            for(auto it = tupleVector.begin(); it != tupleVector.end();)
+            {
+              auto equalPcRange = conn::utils::findRange(it, tupleVector.end(), *it, conn::utils::TpleComp<cclTupleIds::Pc>());
 
-              for(auto it = tupleVector.begin(); it != tupleVector.end();)
-              {
-                auto equalPcRange = conn::utils::findRange(it, tupleVector.end(), *it, conn::utils::TpleComp<cclTupleIds::Pc>()); 
+              pieces.emplace_back(std::get<cclTupleIds::Pc>(*it), std::distance(equalPcRange.first, equalPcRange.second), 0);
 
-                auto pcSize = std::distance(equalPcRange.first, equalPcRange.second);
+              it = equalPcRange.second;
+            }
+          }
 
-                if(equalPcRange.first == tupleVector.begin())   //First bucket
-                {
-                  firstPc.first = std::get<cclTupleIds::Pc>(*it);
-                  firstPc.second = pcSize;
-                }
-                else if(equalPcRange.first != tupleVector.begin() && equalPcRange.second == tupleVector.end())   //Last bucket (and different from first bucket)
-                {
-                  lastPc.first = std::get<cclTupleIds::Pc>(*it);
-                  lastPc.second = pcSize;
-                }
-                else
-                {
-                  if(pcSize > middlePc.second)
-                  {
-                    middlePc.first = std::get<cclTupleIds::Pc>(*it);
-                    middlePc.second = pcSize;
-                  }
-                }
+          //Self tuples are counted in the component of their vertex
+          if(storage == conn::graphGen::edgeStorage::halfEdges)
+          {
+            std::vector<std::pair<nodeIdType, pIdtype>> labels;
+            getVertexLabels(labels);
 
-                it = equalPcRange.second;
-              }
-              
-              if(firstPc.second > 0) partitionSizeVector.push_back(firstPc);
-              if(middlePc.second > 0) partitionSizeVector.push_back(middlePc);
-              if(lastPc.second > 0) partitionSizeVector.push_back(lastPc);
+            std::vector<pIdtype> selfTupleLabels(selfTupleSources.size());
+            lookupVertexLabels(labels, selfTupleSources.data(), selfTupleSources.size(), 1, selfTupleLabels.data(), comm);
 
-              //Gather all sizes to rank 0
-              auto globalPartitionSizeVector = mxx::gatherv(partitionSizeVector, 0, comm);
+            std::sort(selfTupleLabels.begin(), selfTupleLabels.end());
 
-              if(comm.rank() == 0)
-              {
-                const int PcLayer = 0, sizeLayer = 1;
+            for(auto it = selfTupleLabels.begin(); it != selfTupleLabels.end();)
+            {
+              auto last = std::upper_bound(it, selfTupleLabels.end(), *it);
+              pieces.emplace_back(*it, 0, std::distance(it, last));
+              it = last;
+            }
+          }
 
-                for(auto it = globalPartitionSizeVector.begin(); it != globalPartitionSizeVector.end();)
-                {
-                  //Pairs corresponding to same Pc
-                  auto equalPcRange = conn::utils::findRange(it, globalPartitionSizeVector.end(), *it, conn::utils::TpleComp<PcLayer>());
+          mxx::all2all_func(pieces, [&](const std::tuple<E, std::size_t, std::size_t> &e){
+              return (int) (static_cast<uint64_t>(std::get<0>(e)) % comm.size());
+              }, comm);
 
-                  auto thisSize = std::accumulate(equalPcRange.first, equalPcRange.second, static_cast<E>(0), [&](const E &p1, const std::pair<E,E> &p2){
-                      return p1 + std::get<sizeLayer>(p2);
-                      });
+          std::sort(pieces.begin(), pieces.end());
 
-                  if(thisSize > largestComponentSize)
-                    largestComponentSize = thisSize;
+          std::size_t largestComponentSize = 0;
 
+          for(auto it = pieces.begin(); it != pieces.end();)
+          {
+            auto equalPcRange = conn::utils::findRange(it, pieces.end(), *it, conn::utils::TpleComp<0>());
 
-                  it = equalPcRange.second;
-                }
-              }
-          });
+            std::size_t tuples = 0, selfTuples = 0;
+            std::for_each(equalPcRange.first, equalPcRange.second, [&](const std::tuple<E, std::size_t, std::size_t> &e){
+                tuples += std::get<1>(e);
+                selfTuples += std::get<2>(e);
+                });
+
+            std::size_t edges = (storage == conn::graphGen::edgeStorage::halfEdges) ? tuples - selfTuples : tuples/2;
+            largestComponentSize = std::max(largestComponentSize, edges);
 
-          largestComponentSize = mxx::allreduce(largestComponentSize, mxx::max<std::size_t>(), comm);
+            it = equalPcRange.second;
+          }
 
-          return largestComponentSize/2;
+          return mxx::allreduce(largestComponentSize, mxx::max<std::size_t>(), comm);
         }
 
+        /**
+         * @brief     Common to the constructors, after the tuples are built
+         */
+        void prepareTuples()
+        {
+          //hash_64 is a bijection over 64 bit keys only
+          if(sizeof(nodeIdType) != 8)
+            this->priority = labelPriority::vertexId;
+
+          if(this->priority == labelPriority::randomHash && !hashAvoidsReservedIds())
+          {
+            LOG_IF(comm.rank() == 0, WARNING) << "A vertex id hashes to a reserved label, using the vertex id priority";
+            this->priority = labelPriority::vertexId;
+          }
+
+          if(this->priority == labelPriority::randomHash)
+            permuteTupleIds(true);
 
-      private:
+          //Re-distribute the tuples uniformly across the ranks
+          mxx::distribute_inplace(tupleVector, comm);
+
+          if(placement != conn::utils::memPlacement::firstTouch)
+          {
+            placeTupleVector();
+            conn::utils::printMemPlacement(tupleVector, "tuple vector", comm);
+          }
+        }
 
         /**
          * @brief     Free the communicator
@@ -240,17 +557,48 @@ namespace conn
          * @details   For the bucket in the edgeList ...<(u, v1), (u,v2)>...
          *            we append <(u, ~, u), (u, ~, v1), (u, ~, v2)> to our tupleVector
          *            We ignore the bucket splits across ranks here, because that shouldn't affect the correctness and complexity
+         *
+         *            With halfEdges storage, the reverse tuple (v, ~, u) is never built. Instead each source u
+         *            gets a self tuple (u, ~, u), which ties partition u to vertex u. Partition u is then 
+         *            {u} + its listed neighbors, and the partitions overlap exactly along the edges, so the 
+         *            components are unchanged while the tuple count drops from 2|E| to |E| + |V_src|
          */
         template <typename edgeListPairsType>
           void convertEdgeListforCCL(edgeListPairsType &edgeList)
           {
             Timer timer(std::cerr, comm);
 
+            std::size_t selfTupleCount = 0;
+
+            if(storage == conn::graphGen::edgeStorage::halfEdges)
+            {
+              //Local sort by source to count the source vertices
+              std::sort(edgeList.begin(), edgeList.end(), conn::utils::TpleComp<edgeListTIds::src>());
+
+              for(auto it = edgeList.begin(); it != edgeList.end(); it++)
+                if(it == edgeList.begin() || std::get<edgeListTIds::src>(*it) != std::get<edgeListTIds::src>(*(it-1)))
+                  selfTupleCount++;
+            }
+
             //Reserve the approximate required space in our vector
-            tupleVector.reserve(edgeList.size());
+            tupleVector.reserve(edgeList.size() + selfTupleCount);
+            selfTupleSources.reserve(selfTupleCount);
+
+            //Advise placement before the pages are touched
+            placeTupleVector();
 
             for(auto it = edgeList.begin(); it != edgeList.end(); it++)
+            {
+              //Self tuple, once per source (edgeList is sorted by source in this mode)
+              if(selfTupleCount > 0)
+                if(it == edgeList.begin() || std::get<edgeListTIds::src>(*it) != std::get<edgeListTIds::src>(*(it-1)))
+                {
+                  tupleVector.emplace_back(std::get<edgeListTIds::src>(*it), MAX_PID, std::get<edgeListTIds::src>(*it));
+                  selfTupleSources.push_back(std::get<edgeListTIds::src>(*it));
+                }
+
               tupleVector.emplace_back(std::get<edgeListTIds::src>(*it), MAX_PID, std::get<edgeListTIds::dst>(*it));;
+            }
 
             timer.end_section("vector of tuples initialized for ccl");
 
@@ -260,6 +608,75 @@ namespace conn
             LOG_IF(comm.rank() == 0, INFO) << "Total tuple count is " << totalTupleCount;
           }
 
+        /**
+         * @brief     builds the tuples from the chunks of an edge generator, same as convertEdgeListforCCL
+         * @details   With halfEdges storage, self tuples are added per chunk. A source spread over
+         *            chunks gets a self tuple in each, which like a bucket split across ranks is harmless
+         */
+        template <typename Generator>
+          void convertEdgeSourceforCCL(Generator &source)
+          {
+            Timer timer(std::cerr, comm);
+
+            bool halfEdges = (storage == conn::graphGen::edgeStorage::halfEdges);
+
+            //Self tuples are counted per chunk, the edges alone are reserved first
+            std::size_t hint = source.sizeHint();
+            tupleVector.reserve(hint);
+
+            //Advise placement before the pages are touched
+            placeTupleVector();
+
+            std::vector<std::pair<nodeIdType, nodeIdType>> chunk;
+            std::size_t edgesPulled = 0;
+
+            while(source.next(chunk))
+            {
+              std::size_t chunkTuples = chunk.size();
+
+              if(halfEdges)
+              {
+                std::sort(chunk.begin(), chunk.end(), conn::utils::TpleComp<edgeListTIds::src>());
+
+                //One self tuple per distinct source of the chunk
+                for(auto it = chunk.begin(); it != chunk.end(); it++)
+                  if(it == chunk.begin() || std::get<edgeListTIds::src>(*it) != std::get<edgeListTIds::src>(*(it-1)))
+                    chunkTuples++;
+              }
+
+              edgesPulled += chunk.size();
+
+              //Grow to the projected total, at the tuples per edge seen so far
+              if(tupleVector.size() + chunkTuples > tupleVector.capacity())
+              {
+                double tuplesPerEdge = (double) (tupleVector.size() + chunkTuples) / edgesPulled;
+                std::size_t remainingEdges = hint > edgesPulled ? hint - edgesPulled : 0;
+
+                tupleVector.reserve(tupleVector.size() + chunkTuples + (std::size_t) (tuplesPerEdge * remainingEdges));
+                placeTupleVector();
+              }
+
+              for(auto it = chunk.begin(); it != chunk.end(); it++)
+              {
+                if(halfEdges)
+                  if(it == chunk.begin() || std::get<edgeListTIds::src>(*it) != std::get<edgeListTIds::src>(*(it-1)))
+                  {
+                    tupleVector.emplace_back(std::get<edgeListTIds::src>(*it), MAX_PID, std::get<edgeListTIds::src>(*it));
+                    selfTupleSources.push_back(std::get<edgeListTIds::src>(*it));
+                  }
+
+                tupleVector.emplace_back(std::get<edgeListTIds::src>(*it), MAX_PID, std::get<edgeListTIds::dst>(*it));
+              }
+            }
+
+            timer.end_section("vector of tuples initialized for ccl from the edge generator");
+
+            //Log the total count of tuples
+            auto totalTupleCount = mxx::reduce(tupleVector.size(), 0, comm);
+
+            LOG_IF(comm.rank() == 0, INFO) << "Total tuple count is " << totalTupleCount;
+          }
+
         /**
          * @brief     run the iterative algorithm for ccl
          */
@@ -276,7 +693,7 @@ namespace conn
           //Initially all the tuples are active, therefore we set distance_begin_mid to 0
           std::size_t distance_begin_mid = 0;
 
-          while(!converged)
+          while(!converged && (iterationLimit == 0 || iterCount < iterationLimit))
           {
 
             LOG_IF(comm.rank() == 0, INFO) << "Iteration #" << iterCount + 1;
@@ -299,6 +716,14 @@ namespace conn
             updatePn(mid, tupleVector.end());
 
             timer.end_section("Pn update done");
+
+            //Keep one tuple per interior node, only the boundary takes part in the sorts
+            if(OPTIMIZATION == opt_level::boundary_active_set)
+            {
+              setAsideInteriorTuples(mid, tupleVector.end());
+
+              timer.end_section("Interior tuples set aside");
+            }
             
             //Update the Pc layer, choose the best candidate
             converged = updatePc(mid, tupleVector.end(), parentRequestTupleVector);
@@ -312,7 +737,12 @@ namespace conn
 
               //Due to insertion and deletion of elements, block decomposed property is lost during 
               //the pointer doubling, so redo it
-              mxx::distribute_inplace(tupleVector, comm);
+              //With load balancing, this is left to the rebalancing after the stable partitions are removed
+              if(OPTIMIZATION < opt_level::loadbalanced)
+                mxx::distribute_inplace(tupleVector, comm);
+
+              //Vector may have been reallocated
+              placeTupleVector();
 
               timer.end_section("Pointer doubling done");
             }
@@ -327,17 +757,36 @@ namespace conn
             end = tupleVector.end();
 
             //parition the dataset into stable and active paritions, if optimization is enabled
-            if(!converged && (OPTIMIZATION == opt_level::stable_partition_removed || OPTIMIZATION == opt_level::loadbalanced))
+            if(!converged && OPTIMIZATION >= opt_level::stable_partition_removed)
             {
               //use std::partition to move stable tuples to the left
               mid = partitionStableTuples<cclTupleIds::Pn>(mid, end);
 
               timer.end_section("Stable partitons placed aside");
 
-              if(OPTIMIZATION == opt_level::loadbalanced)
+              //Earlier stable tuples are compressed already, so [begin, mid) holds the new ones
+              if(compressStable)
+              {
+                compressStableTuples(begin, mid);
+
+                begin = tupleVector.begin();
+                mid = tupleVector.begin();
+
+                timer.end_section("Stable tuples compressed");
+              }
+
+              if(OPTIMIZATION >= opt_level::loadbalanced)
               {
-                mid = mxx::block_decompose_partitions_right(begin, mid, end, comm);
-                //Re distributed the tuples to balance the load across the ranks
+                distance_begin_mid = std::distance(begin, mid);
+
+                //Re distribute the tuples to balance the load across the ranks, if needed
+                if(rebalanceActiveTuples(distance_begin_mid))
+                {
+                  begin = tupleVector.begin();
+                  mid = tupleVector.begin() + distance_begin_mid;
+
+                  placeTupleVector();
+                }
               
                 timer.end_section("Load balanced");
               }
@@ -345,9 +794,89 @@ namespace conn
             distance_begin_mid = std::distance(begin, mid);
 
             iterCount ++;
+
+            if(progressEstimates)
+              printComponentEstimates();
           }
 
+          if(!converged)
+            LOG_IF(comm.rank() == 0, INFO) << "Iteration limit reached before convergence, labels are partial";
+
           LOG_IF(comm.rank() == 0, INFO) << "Algorithm took " << iterCount << " iterations";
+
+          if(OPTIMIZATION >= opt_level::loadbalanced)
+            LOG_IF(comm.rank() == 0, INFO) << "Active tuples redistributed in " << rebalanceCount << " of them";
+
+          if(compressStable)
+          {
+            std::size_t storedTuples = mxx::allreduce(stableStore.size(), std::plus<std::size_t>(), comm);
+            std::size_t storedBytes = mxx::allreduce(stableStore.bytes(), std::plus<std::size_t>(), comm);
+
+            LOG_IF(comm.rank() == 0, INFO) << "Stable tuples compressed : " << storedTuples << " tuples in " << storedBytes << " bytes";
+          }
+
+          //Both need all the tuples
+          if(OPTIMIZATION == opt_level::boundary_active_set || priority == labelPriority::randomHash)
+            decodeStableTuples();
+
+          if(OPTIMIZATION == opt_level::boundary_active_set)
+            restoreInteriorTuples();
+
+          //Translate the labels back to vertex ids
+          if(priority == labelPriority::randomHash)
+            permuteTupleIds(false);
+        }
+
+        /**
+         * @brief             checks that no vertex id hashes to MAX_PID or MAX_PID2
+         * @details           hash_64 is a bijection, so exactly one id maps onto each of them.
+         *                    Should be called before permuteTupleIds(true)
+         * @return            true if no rank has either of these ids in its tuples
+         */
+        bool hashAvoidsReservedIds()
+        {
+          //Ids which would hash to the reserved values
+          uint64_t reserved = static_cast<uint64_t>(MAX_PID);
+          uint64_t reserved2 = static_cast<uint64_t>(MAX_PID2);
+          conn::graphGen::hash_64i(reserved);
+          conn::graphGen::hash_64i(reserved2);
+
+          int hit = std::any_of(tupleVector.begin(), tupleVector.end(), [&](const T &e){
+              uint64_t pc = static_cast<uint64_t>(std::get<cclTupleIds::Pc>(e));
+              uint64_t nid = static_cast<uint64_t>(std::get<cclTupleIds::nId>(e));
+              return pc == reserved || pc == reserved2 || nid == reserved || nid == reserved2;
+              });
+
+          return !mxx::allreduce(hit, mxx::max<int>(), comm);
+        }
+
+        /**
+         * @brief             applies the bijective hash_64 (or its inverse) to the Pc and nId layers
+         * @details           Minimum of the hashed ids behaves like a random priority, so the
+         *                    winning label is no longer at the end of a sequentially numbered path.
+         *                    Hashed ids must not hit the reserved MAX_PID, MAX_PID2 values, see hashAvoidsReservedIds
+         */
+        void permuteTupleIds(bool forward)
+        {
+          for(auto &e : tupleVector)
+          {
+            uint64_t pc = static_cast<uint64_t>(std::get<cclTupleIds::Pc>(e));
+            uint64_t nid = static_cast<uint64_t>(std::get<cclTupleIds::nId>(e));
+
+            if(forward)
+            {
+              conn::graphGen::hash_64(pc);
+              conn::graphGen::hash_64(nid);
+            }
+            else
+            {
+              conn::graphGen::hash_64i(pc);
+              conn::graphGen::hash_64i(nid);
+            }
+
+            std::get<cclTupleIds::Pc>(e) = static_cast<pIdtype>(pc);
+            std::get<cclTupleIds::nId>(e) = static_cast<nodeIdType>(nid);
+          }
         }
 
         /**
@@ -362,7 +891,7 @@ namespace conn
           {
 
               //Sort by nid,Pc
-              mxx::sort(begin, end, conn::utils::TpleComp2Layers<cclTupleIds::nId, cclTupleIds::Pc>(), com); 
+              sortTuples(begin, end, conn::utils::TpleComp2Layers<cclTupleIds::nId, cclTupleIds::Pc>(), com); 
 
               //Resolve last and first bucket's boundary splits
 
@@ -428,9 +957,167 @@ namespace conn
                 //Advance the loop pointer
                 it = equalRange.second;
               }
+
+              if(RELAXATION)
+                relaxLocally(begin, end);
+          });
+        }
+
+        /**
+         * @brief             moves the redundant tuples of the interior nodes to interiorTuples
+         * @param[in] begin   active tuples, sorted by nId and with the Pn layer updated
+         * @param[in] end     must be tupleVector.end()
+         * @details           A node is interior when all its tuples have the same Pc (Pn = MAX_PID2).
+         *                    Partitions only merge as a whole, so the tuples of an interior node keep
+         *                    sharing their Pc till the end, and a single representative tuple
+         *                    (per rank) is enough to carry the node along with its partition. 
+         *                    Others are erased from tupleVector, and relabeled later by 
+         *                    restoreInteriorTuples()
+         */
+        template <typename Iterator>
+        void setAsideInteriorTuples(Iterator begin, Iterator end)
+        {
+          auto out = begin;
+
+          for(auto it = begin; it != end; it++)
+          {
+            bool redundant = std::get<cclTupleIds::Pn>(*it) == MAX_PID2 && it != begin 
+              && std::get<cclTupleIds::nId>(*it) == std::get<cclTupleIds::nId>(*(it-1));
+
+            if(redundant)
+              interiorTuples.push_back(*it);
+            else
+            {
+              //Position it-1 is either untouched or rewritten with its own value, so the check above stays valid
+              if(out != it) *out = *it;
+              out++;
+            }
+          }
+
+          tupleVector.erase(out, end);
+        }
+
+        /**
+         * @brief     puts the interior tuples back in tupleVector with the final label of their node
+         * @details   Set aside tuples get Pc = MAX_PID, so that after sorting by <nId, Pc> the 
+         *            representative tuple of each node leads its bucket and provides the label
+         */
+        void restoreInteriorTuples()
+        {
+          std::size_t restoreCount = mxx::allreduce(interiorTuples.size(), std::plus<std::size_t>(), comm);
+
+          LOG_IF(comm.rank() == 0, INFO) << "Interior tuples set aside : " << restoreCount;
+
+          if(restoreCount == 0)
+            return;
+
+          for(auto &e : interiorTuples)
+            std::get<cclTupleIds::Pc>(e) = MAX_PID;
+
+          tupleVector.insert(tupleVector.end(), interiorTuples.begin(), interiorTuples.end());
+          std::vector<T>().swap(interiorTuples);
+
+          mxx::distribute_inplace(tupleVector, comm);
+
+          auto begin = tupleVector.begin();
+          auto end = tupleVector.end();
+
+          comm.with_subset(begin != end, [&](const mxx::comm& com){
+
+              //Same bucket resolution as updatePn()
+              sortTuples(begin, end, conn::utils::TpleComp2Layers<cclTupleIds::nId, cclTupleIds::Pc>(), com); 
+              auto minPcOfLastBucket = mxx::local_reduce(begin, end, conn::utils::TpleReduce2Layers<cclTupleIds::nId, cclTupleIds::Pc, std::greater, std::less>());
+              auto prevMinPc = mxx::exscan(minPcOfLastBucket, conn::utils::TpleReduce2Layers<cclTupleIds::nId, cclTupleIds::Pc, std::greater, std::less>(), com);  
+
+              for(auto it = begin; it !=  end;)
+              {
+                auto equalRange = conn::utils::findRange(it, end, *it, conn::utils::TpleComp<cclTupleIds::nId>());
+                auto thisBucketsMinPc = mxx::local_reduce(equalRange.first, equalRange.second, conn::utils::TpleReduce<cclTupleIds::Pc>());
+                if(equalRange.first == begin && com.rank() > 0)
+                  thisBucketsMinPc = conn::utils::TpleReduce2Layers<cclTupleIds::nId, cclTupleIds::Pc, std::greater, std::less>() (prevMinPc, thisBucketsMinPc);
+
+                std::for_each(equalRange.first, equalRange.second, [&](T &e){
+                    if(std::get<cclTupleIds::Pc>(e) == MAX_PID)
+                      std::get<cclTupleIds::Pc>(e) = std::get<cclTupleIds::Pc>(thisBucketsMinPc);
+                    });
+
+                it = equalRange.second;
+              }
           });
         }
 
+        /**
+         * @brief             propagates the Pn candidates to a fixpoint among the tuples on this rank
+         * @param[in] begin   active tuples, sorted by nId and with the Pn layer updated
+         * @param[in] end     end iterator
+         * @details           Partitions which share a node on this rank are merged with a local
+         *                    union-find, and every active tuple takes the minimum label (Pc or node id)
+         *                    of its merged set as Pn. All the labels of a set belong to one component,
+         *                    and the minimum never exceeds the one hop candidate, so the iteration
+         *                    stays correct while advancing several hops per global sort.
+         *                    Stable tuples (Pn = MAX_PID2) are left as they are
+         */
+        template <typename Iterator>
+        void relaxLocally(Iterator begin, Iterator end)
+        {
+          //Unique partition ids on this rank, index in this array is the union-find element
+          std::vector<pIdtype> partitions;
+          partitions.reserve(std::distance(begin, end));
+          for(auto it = begin; it != end; it++)
+            partitions.push_back(std::get<cclTupleIds::Pc>(*it));
+
+          std::sort(partitions.begin(), partitions.end());
+          partitions.erase(std::unique(partitions.begin(), partitions.end()), partitions.end());
+
+          auto indexOf = [&](pIdtype pc){
+            return std::distance(partitions.begin(), std::lower_bound(partitions.begin(), partitions.end(), pc));
+          };
+
+          std::vector<std::size_t> uf(partitions.size());
+          std::iota(uf.begin(), uf.end(), 0);
+
+          //Minimum label in the set, valid at the roots
+          std::vector<pIdtype> minLabel(partitions);
+
+          auto find = [&](std::size_t x) -> std::size_t {
+            while(uf[x] != x)
+            {
+              uf[x] = uf[uf[x]];
+              x = uf[x];
+            }
+            return x;
+          };
+
+          //Merge the partitions of each active node bucket
+          for(auto it = begin; it != end;)
+          {
+            auto equalRange = conn::utils::findRange(it, end, *it, conn::utils::TpleComp<cclTupleIds::nId>());
+
+            if(std::get<cclTupleIds::Pn>(*it) != MAX_PID2)
+            {
+              std::size_t root = find(indexOf(std::get<cclTupleIds::Pc>(*it)));
+              minLabel[root] = std::min(minLabel[root], std::get<cclTupleIds::Pn>(*it));
+
+              std::for_each(equalRange.first + 1, equalRange.second, [&](const T &e){
+                  std::size_t r = find(indexOf(std::get<cclTupleIds::Pc>(e)));
+                  if(r != root)
+                  {
+                    uf[r] = root;
+                    minLabel[root] = std::min(minLabel[root], minLabel[r]);
+                  }
+                  });
+            }
+
+            it = equalRange.second;
+          }
+
+          //Take the minimum of the set as the candidate
+          std::for_each(begin, end, [&](T &e){
+              if(std::get<cclTupleIds::Pn>(e) != MAX_PID2)
+                std::get<cclTupleIds::Pn>(e) = std::min(std::get<cclTupleIds::Pn>(e), minLabel[find(indexOf(std::get<cclTupleIds::Pc>(e)))]);
+              });
+        }
+
         /**
          * @brief                             update the Pc layer by choosing min Pn
          * @param[in] begin                   To iterate over the vector of tuples, marks the range of active tuples 
@@ -444,11 +1131,13 @@ namespace conn
             //converged yet
             uint8_t converged = 1;    // 1 means true, we will update it below
 
+            largestActivePiece = 0;
+
             //Work only among ranks which have non-zero tuples left
             comm.with_subset(begin != end, [&](const mxx::comm& com)
             {
                 //Sort by Pc, Pn
-                mxx::sort(begin, end, conn::utils::TpleComp2Layers<cclTupleIds::Pc, cclTupleIds::Pn>(), com); 
+                sortTuples(begin, end, conn::utils::TpleComp2Layers<cclTupleIds::Pc, cclTupleIds::Pn>(), com); 
 
                 //Resolve last bucket's boundary split
 
@@ -490,6 +1179,8 @@ namespace conn
                     //Algorithm not converged yet because we found an active partition
                     converged = 0;
 
+                    largestActivePiece = std::max(largestActivePiece, (std::size_t) std::distance(equalRange.first, equalRange.second));
+
                     //Update Pc
                     std::for_each(equalRange.first, equalRange.second, [&](T &e){
                         std::get<cclTupleIds::Pc>(e) = std::get<cclTupleIds::Pn>(thisBucketsMinPnGlobal);
@@ -505,6 +1196,10 @@ namespace conn
                     std::for_each(equalRange.first, equalRange.second, [&](T &e){
                         std::get<cclTupleIds::Pn>(e) = MAX_PID;
                         });
+
+                    //Stable partitions leave the active set, so each is seen here exactly once
+                    if(OPTIMIZATION >= opt_level::stable_partition_removed)
+                      accumulateStablePartition(equalRange.first, equalRange.second, begin, end);
                   }
 
                   //Advance the loop pointer
@@ -520,6 +1215,107 @@ namespace conn
             return (allConverged == 1  ? true : false);
           }
 
+        /**
+         * @brief     count of the components whose partitions are stable, merges the split partitions
+         *            recorded by accumulateStablePartition()
+         */
+        std::size_t countStableComponents()
+        {
+          auto globalPieces = mxx::gatherv(stableBoundaryPieces, 0, comm);
+
+          std::size_t componentCount = stableComponentCount;
+
+          if(comm.rank() == 0)
+          {
+            std::sort(globalPieces.begin(), globalPieces.end());
+
+            //Same Pc with and without the node Pc sorts the latter last
+            for(auto it = globalPieces.begin(); it != globalPieces.end(); it++)
+              if(std::get<1>(*it) && (it + 1 == globalPieces.end() || std::get<0>(*(it + 1)) != std::get<0>(*it)))
+                componentCount++;
+          }
+
+          return mxx::allreduce(componentCount, std::plus<std::size_t>(), comm);
+        }
+
+        /**
+         * @brief                 records the count and size of a partition which just became stable
+         * @param[in] first       range of the partition's tuples on this rank
+         * @param[in] last        end of the range
+         * @param[in] begin       active tuples on this rank, sorted by Pc
+         * @param[in] end         end iterator
+         * @details               A component may stabilize as several partitions with the same Pc, in
+         *                        different iterations (with bothWays storage, partition v need not hold 
+         *                        node v). Only the one holding the tuples of node Pc is counted, those 
+         *                        tuples are never split among partitions once the node is stable.
+         *                        Partitions at the rank boundaries are resolved in computeComponentCount()
+         */
+        template <typename Iterator>
+          void accumulateStablePartition(Iterator first, Iterator last, Iterator begin, Iterator end)
+          {
+            auto pc = std::get<cclTupleIds::Pc>(*first);
+
+            bool holdsNodePc = std::any_of(first, last, [&](const T &e){
+                return std::get<cclTupleIds::nId>(e) == pc;
+                });
+
+            if(first == begin || last == end)
+              stableBoundaryPieces.emplace_back(pc, holdsNodePc);
+            else if(holdsNodePc)
+              stableComponentCount++;
+
+            stablePartitionSizes.emplace_back(pc, std::distance(first, last));
+
+            largestStablePiece = std::max(largestStablePiece, (std::size_t) std::distance(first, last));
+          }
+
+        /**
+         * @brief                   redistributes the active tuples evenly across the ranks, if they are imbalanced
+         * @param[in] beginOffset   tupleVector.begin() + beginOffset marks the begin of the active tuples
+         * @details                 Imbalance is the max/mean count of the active tuples (see printWorkLoad),
+         *                          nothing moves unless it exceeds rebalanceThreshold. Only the active 
+         *                          tuples are redistributed, stable partitions stay on their rank
+         * @note                    The active tail is exchanged straight out of tupleVector into a buffer of
+         *                          its balanced size, and copied back after the truncation, so the extra
+         *                          memory is one balanced share of the active tuples
+         * @return                  true if the tuples were moved, iterators over tupleVector are invalid then
+         */
+        bool rebalanceActiveTuples(std::size_t beginOffset)
+        {
+          std::size_t localLoad = tupleVector.size() - beginOffset;
+
+          std::size_t maxLoad = mxx::allreduce(localLoad, mxx::max<std::size_t>(), comm);
+          std::size_t totalLoad = mxx::allreduce(localLoad, std::plus<std::size_t>(), comm);
+
+          if(maxLoad * comm.size() <= rebalanceThreshold * totalLoad)
+            return false;
+
+          //Global position of the first local active tuple, and its block decomposed owners
+          std::size_t globalBegin = mxx::exscan(localLoad, comm);
+          mxx::partition::block_decomposition<std::size_t> part(totalLoad, comm.size(), comm.rank());
+
+          std::vector<std::size_t> sendCounts(comm.size(), 0);
+          for(std::size_t i = globalBegin; i < globalBegin + localLoad; )
+          {
+            int r = part.target_processor(i);
+            std::size_t upto = std::min(part.excl_prefix_size(r) + part.local_size(r), globalBegin + localLoad);
+            sendCounts[r] = upto - i;
+            i = upto;
+          }
+
+          auto recvCounts = mxx::all2all(sendCounts, comm);
+
+          std::vector<T> activeTuples(part.local_size());
+          mxx::all2allv(tupleVector.data() + beginOffset, sendCounts, activeTuples.data(), recvCounts, comm);
+
+          tupleVector.resize(beginOffset);
+          tupleVector.insert(tupleVector.end(), activeTuples.begin(), activeTuples.end());
+
+          rebalanceCount++;
+
+          return true;
+        }
+
         /**
          * @brief                               Function that performs the pointer doubling
          *
@@ -543,16 +1339,27 @@ namespace conn
           //Copy the tuples from parentRequestTupleVector to tupleVector 
           tupleVector.insert(tupleVector.end(), parentRequestTupleVector.begin(), parentRequestTupleVector.end());
 
-          mxx::distribute_inplace(tupleVector, comm);
-
           //Range of active tuples in tupleVector needs to be updated 
           auto begin = tupleVector.begin() + beginOffset;
           auto end = tupleVector.end();
 
-          //Need to block decompose right hand portion
-          begin = mxx::block_decompose_partitions_right(tupleVector.begin(), begin, end, comm);
-          end = tupleVector.end();  //Redefine, above function is not inplace
-          beginOffset = std::distance(tupleVector.begin(), begin);
+          if(OPTIMIZATION >= opt_level::loadbalanced)
+          {
+            //'parentRequest' tuples are few, only move the tuples if they tilt the load
+            rebalanceActiveTuples(beginOffset);
+
+            begin = tupleVector.begin() + beginOffset;
+            end = tupleVector.end();
+          }
+          else
+          {
+            mxx::distribute_inplace(tupleVector, comm);
+
+            //Need to block decompose right hand portion
+            begin = mxx::block_decompose_partitions_right(tupleVector.begin(), tupleVector.begin() + beginOffset, tupleVector.end(), comm);
+            end = tupleVector.end();  //Redefine, above function is not inplace
+            beginOffset = std::distance(tupleVector.begin(), begin);
+          }
 
           //Work among ranks with non-zero count of tuples
           comm.with_subset(begin != end, [&](const mxx::comm& com){
@@ -561,7 +1368,7 @@ namespace conn
               //   We can distinguish the 'parentRequest' tuples as they have Pc = MAX_PID
 
               //Same code as updatePn()
-              mxx::sort(begin, end, conn::utils::TpleComp2Layers<cclTupleIds::nId, cclTupleIds::Pc>(), com); 
+              sortTuples(begin, end, conn::utils::TpleComp2Layers<cclTupleIds::nId, cclTupleIds::Pc>(), com); 
               auto minPcOfLastBucket = mxx::local_reduce(begin, end, conn::utils::TpleReduce2Layers<cclTupleIds::nId, cclTupleIds::Pc, std::greater, std::less>());
               auto prevMinPc = mxx::exscan(minPcOfLastBucket, conn::utils::TpleReduce2Layers<cclTupleIds::nId, cclTupleIds::Pc, std::greater, std::less>(), com);  
               for(auto it = begin; it !=  end;)
@@ -591,7 +1398,7 @@ namespace conn
               }
 
               //2. Now repeat the procedure of updatePc()
-              mxx::sort(begin, end, conn::utils::TpleComp2Layers<cclTupleIds::Pc, cclTupleIds::Pn>(), com); 
+              sortTuples(begin, end, conn::utils::TpleComp2Layers<cclTupleIds::Pc, cclTupleIds::Pn>(), com); 
               auto minPnOfLastBucket = mxx::local_reduce(begin, end, conn::utils::TpleReduce2Layers<cclTupleIds::Pc, cclTupleIds::Pn, std::greater, std::less>());
               auto prevMinPn = mxx::exscan(minPnOfLastBucket, conn::utils::TpleReduce2Layers<cclTupleIds::Pc, cclTupleIds::Pn, std::greater, std::less>(), com);  
               for(auto it = begin; it !=  end;)
@@ -650,6 +1457,73 @@ namespace conn
                 });
           }
 
+        /**
+         * @brief     applies the placement policy to tupleVector, if its buffer changed since the last call
+         * @details   Pages of a buffer already placed stay where they are, so the advice and the
+         *            migration are skipped when the vector was not reallocated
+         */
+        void placeTupleVector()
+        {
+          if(tupleVector.data() == placedBuffer && tupleVector.capacity() == placedCapacity)
+            return;
+
+          conn::utils::applyMemPlacement(tupleVector, placement);
+
+          placedBuffer = tupleVector.data();
+          placedCapacity = tupleVector.capacity();
+        }
+
+        /**
+         * @brief     moves the stable tuples at the front of tupleVector into stableStore
+         * @details   Capacity is released once the vector is less than half full
+         */
+        void compressStableTuples(typename std::vector<T>::iterator begin, typename std::vector<T>::iterator mid)
+        {
+          stableStore.append(begin, mid);
+          tupleVector.erase(begin, mid);
+
+          if(2 * tupleVector.size() < tupleVector.capacity())
+          {
+            tupleVector.shrink_to_fit();
+            placeTupleVector();
+          }
+        }
+
+        /**
+         * @brief     brings the compressed stable tuples back into tupleVector, no-op if there are none
+         */
+        void decodeStableTuples()
+        {
+          if(stableStore.size() > 0)
+            stableStore.decode(tupleVector, MAX_PID);
+        }
+
+        /**
+         * @brief     distributed sort of the range, bounded by sortMemoryBudget if it is set
+         */
+        template <typename Iterator, typename Compare>
+        void sortTuples(Iterator begin, Iterator end, Compare cmp, const mxx::comm &com)
+        {
+          if(sortMemoryBudget > 0)
+            conn::utils::boundedMemorySort(begin, end, cmp, sortMemoryBudget, com);
+          else
+            mxx::sort(begin, end, cmp, com);
+        }
+
+        /**
+         * @details   Helper function to print the bounds of estimateComponentStatistics()
+         */
+        void printComponentEstimates()
+        {
+          std::size_t lowerBound, upperBound;
+          double largestFraction;
+
+          estimateComponentStatistics(lowerBound, upperBound, largestFraction);
+
+          LOG_IF(comm.rank() == 0, INFO) << "Components estimate : count in [" << lowerBound << ", " << upperBound 
+            << "], largest component holds >= " << largestFraction << " of the tuples";
+        }
+
         /**
          * @details   Helper function to print the load distribution i.e. the active tuples
          *            across ranks during the algorithm's exection. Prints the min, mean and 
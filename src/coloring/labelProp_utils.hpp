@@ -26,7 +26,8 @@
 #ifndef LABEL_PROPAGATION_UTILS_HPP 
 #define LABEL_PROPAGATION_UTILS_HPP
 
-
+//Includes
+#include <string>
 
 namespace conn 
 {
@@ -59,9 +60,35 @@ namespace conn
     {
       naive,          
       stable_partition_removed,  //removes stable partitions from the working set
-      loadbalanced    //enables load balance, recommended setting, used by default
+      loadbalanced,   //enables load balance, recommended setting, used by default
+      boundary_active_set   //loadbalanced, and also sets aside the redundant tuples of the interior nodes
+    };
+
+    /**
+     * @brief     order in which the partition labels compete, the minimum label wins
+     */
+    enum labelPriority
+    {
+      vertexId,       //minimum vertex id
+      randomHash      //minimum of a bijective hash of the vertex id, robust to sequentially numbered chains
     };
 
+    /**
+     * @brief     parse the label priority from a command line string (vertexid or random)
+     * @return    false if the string is neither of these
+     */
+    inline bool parseLabelPriority(const std::string &s, labelPriority &priority)
+    {
+      if(s == "vertexid")
+        priority = labelPriority::vertexId;
+      else if(s == "random")
+        priority = labelPriority::randomHash;
+      else
+        return false;
+
+      return true;
+    }
+
     /**
      * @brief   On and off switch
      */
@@ -0,0 +1,323 @@
+/*
+ * Copyright 2016 Georgia Institute of Technology
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    rmaUnionFind.hpp
+ * @ingroup coloring
+ * @brief   Connected components using asynchronous union-find over a parent array
+ *          exposed through MPI-3 one sided communication
+ *
+ * Copyright (c) 2016 Georgia Institute of Technology. All Rights Reserved.
+ */
+
+#ifndef RMA_UNION_FIND_HPP
+#define RMA_UNION_FIND_HPP
+
+//Includes
+#include <mpi.h>
+#include <iostream>
+#include <algorithm>
+#include <numeric>
+
+//Own includes
+#include "utils/commonfuncs.hpp"
+#include "utils/distArray.hpp"
+#include "graphGen/common/utils.hpp"
+
+//External includes
+#include "mxx/comm.hpp"
+#include "mxx/partition.hpp"
+#include "mxx/reduction.hpp"
+#include "extutils/logging.hpp"
+
+namespace conn
+{
+  namespace coloring
+  {
+
+    /**
+     * @class                     conn::coloring::rmaUnionFind
+     * @brief                     connected components using union-find with remote atomics
+     * @tparam[in]  nIdType       type used for node id, 64-bit integer
+     * @details                   Vertex ids must be contiguous in [0, nVertices) (see reduceVertexIds).
+     *                            The parent array is split in contiguous ranges (block decomposed, or the
+     *                            ranges of partitionVertices()) and exposed through an RMA window,
+     *                            each rank links the endpoints of its own edges without waiting for the
+     *                            others:
+     *                            find   follows the parents with atomic reads, and halves the path with
+     *                                   compare-and-swap
+     *                            union  links the larger root below the smaller one with compare-and-swap,
+     *                                   and retries if the root changed meanwhile. Parents only decrease,
+     *                                   so the forest stays acyclic
+     *                            Parents are read with MPI_Fetch_and_op(MPI_NO_OP) rather than MPI_Get,
+     *                            as MPI_Get is not atomic w.r.t. concurrent compare-and-swap.
+     *                            A rank which runs out of edges enters a non-blocking barrier and keeps
+     *                            driving MPI progress for the others, the barrier completes once every
+     *                            rank has linked all its edges
+     */
+    template<typename nIdType = uint64_t>
+    class rmaUnionFind
+    {
+      public:
+
+        //Type for saving node ids
+        using nodeIdType = nIdType;
+
+      private:
+
+        static_assert(sizeof(nodeIdType) == 8 && std::is_integral<nodeIdType>::value, "64-bit integer ids expected");
+
+        //This is the communicator which participates for computing the components
+        mxx::comm comm;
+
+        //Count of the vertices, ids are in [0, nVertices)
+        std::size_t nVertices;
+
+        //Range of the vertex ids owned by each rank
+        conn::utils::rangePartition part;
+
+        //Edges to link, each undirected edge once
+        std::vector<std::pair<nodeIdType, nodeIdType>> edges;
+
+        //Local block of the parent array, memory of the window
+        std::vector<nodeIdType> parent;
+
+        //Final component label of each local vertex
+        std::vector<nodeIdType> labels;
+
+        //Local vertices which have at least one edge
+        std::vector<char> active;
+
+        MPI_Win win;
+        MPI_Datatype mpiType;
+
+        //Telemetry
+        std::size_t rmaOps = 0;
+        std::size_t casRetries = 0;
+
+      public:
+        /**
+         * @brief                 public constructor
+         * @param[in] edgeList    distributed vector of edges, ids in [0, nVertices)
+         * @param[in] nVertices   count of vertices
+         * @param[in] c           mpi communicator for the execution
+         * @param[in] storage     use halfEdges if each undirected edge is present only once in edgeList
+         * @param[in] vertexRanges  count of the vertex ids owned by each rank, as returned by partitionVertices(),
+         *                          the ids are block decomposed if empty
+         */
+        template <typename E>
+        rmaUnionFind(std::vector<std::pair<E,E>> &edgeList, std::size_t nVertices, const mxx::comm &c,
+            conn::graphGen::edgeStorage storage = conn::graphGen::edgeStorage::bothWays,
+            const std::vector<std::size_t> &vertexRanges = std::vector<std::size_t>())
+          : comm(c.copy()), nVertices(nVertices),
+          part(vertexRanges.empty() ? conn::utils::rangePartition(nVertices, c) : conn::utils::rangePartition(vertexRanges, c))
+        {
+          //nodeIdType and E should match
+          static_assert(std::is_same<E, nodeIdType>::value, "types must match");
+
+          const int SRC = 0, DEST = 1;
+
+          mpiType = std::is_signed<nodeIdType>::value ? MPI_INT64_T : MPI_UINT64_T;
+
+          //Union is symmetric, the reverse edges add nothing
+          edges.reserve(storage == conn::graphGen::edgeStorage::halfEdges ? edgeList.size() : edgeList.size() / 2);
+          for(auto &e : edgeList)
+            if(storage == conn::graphGen::edgeStorage::halfEdges || std::get<SRC>(e) < std::get<DEST>(e))
+              edges.push_back(e);
+
+          //Mark the vertices with edges
+          std::vector<std::pair<nodeIdType, char>> endpoints;
+          endpoints.reserve(2 * edges.size());
+          for(auto &e : edges)
+          {
+            endpoints.emplace_back(std::get<SRC>(e), 1);
+            endpoints.emplace_back(std::get<DEST>(e), 1);
+          }
+
+          std::sort(endpoints.begin(), endpoints.end());
+          endpoints.erase(std::unique(endpoints.begin(), endpoints.end()), endpoints.end());
+
+          active.assign(part.local_size(), 0);
+          conn::utils::blockReduce(endpoints, active, part, [](char a, char b){ return (char) (a | b); }, comm);
+
+          parent.resize(part.local_size());
+          std::iota(parent.begin(), parent.end(), part.excl_prefix_size());
+
+          MPI_Win_create(parent.data(), parent.size() * sizeof(nodeIdType), sizeof(nodeIdType), MPI_INFO_NULL, comm, &win);
+        }
+
+        //The window is freed by the destructor, so no copies
+        rmaUnionFind(const rmaUnionFind &) = delete;
+        rmaUnionFind &operator=(const rmaUnionFind &) = delete;
+
+        ~rmaUnionFind()
+        {
+          MPI_Win_free(&win);
+        }
+
+        /**
+         * @brief   Compute the connected component labels
+         */
+        void compute()
+        {
+          MPI_Win_lock_all(0, win);
+
+          for(auto &e : edges)
+            unite(std::get<0>(e), std::get<1>(e));
+
+          //Asynchronous termination, keep progressing until every rank is done linking
+          MPI_Request request;
+          int done = 0;
+          MPI_Ibarrier(comm, &request);
+          while(!done)
+            MPI_Test(&request, &done, MPI_STATUS_IGNORE);
+
+          //No more links, each rank resolves the roots of its own vertices
+          std::size_t offset = part.excl_prefix_size();
+          labels.resize(parent.size());
+          for(std::size_t i = 0; i < labels.size(); i++)
+            labels[i] = find(offset + i);
+
+          MPI_Win_unlock_all(win);
+
+          printTelemetry();
+        }
+
+        /**
+         * @brief     count the components in the graph, i.e. the roots among the vertices with edges
+         * @note      should be called after computing connected components.
+         */
+        std::size_t computeComponentCount()
+        {
+          std::size_t offset = part.excl_prefix_size();
+          std::size_t localRoots = 0;
+
+          for(std::size_t i = 0; i < labels.size(); i++)
+            if(active[i] && labels[i] == offset + i)
+              localRoots++;
+
+          return mxx::allreduce(localRoots, std::plus<std::size_t>(), comm);
+        }
+
+      private:
+
+        /**
+         * @brief     owner rank and displacement of an entry in the parent array
+         */
+        std::pair<int, MPI_Aint> locate(nodeIdType x)
+        {
+          int owner = part.target_processor(x);
+          return std::make_pair(owner, (MPI_Aint) (x - part.excl_prefix_size(owner)));
+        }
+
+        /**
+         * @brief     atomic read of parent[x]
+         */
+        nodeIdType read(nodeIdType x)
+        {
+          auto loc = locate(x);
+          nodeIdType value;
+
+          MPI_Fetch_and_op(nullptr, &value, mpiType, loc.first, loc.second, MPI_NO_OP, win);
+          MPI_Win_flush(loc.first, win);
+          rmaOps++;
+
+          return value;
+        }
+
+        /**
+         * @brief     parent[x] = desired if parent[x] == expected, returns true on success
+         */
+        bool compareAndSwap(nodeIdType x, nodeIdType expected, nodeIdType desired)
+        {
+          auto loc = locate(x);
+          nodeIdType result;
+
+          MPI_Compare_and_swap(&desired, &expected, &result, mpiType, loc.first, loc.second, win);
+          MPI_Win_flush(loc.first, win);
+          rmaOps++;
+
+          return result == expected;
+        }
+
+        /**
+         * @brief     returns the root of x, with path halving
+         */
+        nodeIdType find(nodeIdType x)
+        {
+          nodeIdType p = read(x);
+
+          while(p != x)
+          {
+            nodeIdType gp = read(p);
+
+            //Skip a level, gp is an ancestor of x even if the parents changed meanwhile
+            if(gp != p)
+              compareAndSwap(x, p, gp);
+
+            x = p;
+            p = gp;
+          }
+
+          return x;
+        }
+
+        /**
+         * @brief     merges the trees of u and v
+         */
+        void unite(nodeIdType u, nodeIdType v)
+        {
+          while(true)
+          {
+            nodeIdType ru = find(u);
+            nodeIdType rv = find(v);
+
+            if(ru == rv)
+              return;
+
+            if(ru < rv)
+              std::swap(ru, rv);
+
+            //Link the larger root below the smaller, fails if ru is no longer a root
+            if(compareAndSwap(ru, ru, rv))
+              return;
+
+            casRetries++;
+            u = ru;
+            v = rv;
+          }
+        }
+
+        /**
+         * @details   prints the min-mean-max count of remote operations issued per rank,
+         *            and the total count of failed links
+         */
+        void printTelemetry()
+        {
+          std::size_t minOps = mxx::reduce(rmaOps, 0, mxx::min<std::size_t>(), comm);
+          std::size_t meanOps = mxx::reduce(rmaOps, 0, std::plus<std::size_t>(), comm) / comm.size();
+          std::size_t maxOps = mxx::reduce(rmaOps, 0, mxx::max<std::size_t>(), comm);
+          std::size_t retries = mxx::reduce(casRetries, 0, std::plus<std::size_t>(), comm);
+
+          auto sep = ",";
+          LOG_IF(comm.rank() == 0, INFO) << "RMA union-find, one sided operations min-mean-max : "
+            << minOps << sep << meanOps << sep << maxOps << ", link retries -> " << retries;
+        }
+    };
+  }
+}
+
+#endif
@@ -33,6 +33,7 @@
 
 //Own includes
 #include "utils/commonfuncs.hpp"
+#include "graphGen/common/utils.hpp"
 
 //External includes
 #include "mxx/distribution.hpp"
@@ -72,49 +73,29 @@ namespace conn
       }
 
     /**
-     * @brief                   Decides if its optimal to run BFS iteration based on the degree distribution
-     * @param[in]  edgeList     distributed vector of edges
-     * @return                  true if BFS should be executed, false otherwise
-     * @NOTE                    Assumes each edge is present both ways in the edgeList vector         
+     * @brief                       Accumulates the degree frequency over the vertex buckets of a globally sorted vector
+     * @tparam     VERTEX           layer of the pair holding the vertex id, vector should be globally sorted by it
+     * @param[in]  bucketDegree     functor which returns the degree contributed by a bucket [first, last)
+     * @param[out] degreeCountMap   frequency of each degree, buckets split across ranks are combined on rank 0
+     * @param[out] maxDegree        maximum degree seen by this rank
      */
-    template <typename E>
-      bool runBFSDecision(std::vector<std::pair<E,E>> &edgeList, mxx::comm &comm)
+    template <int VERTEX, typename E, typename BucketDegree>
+      void accumulateDegreeFrequency(std::vector<std::pair<E,E>> &sortedList, BucketDegree bucketDegree,
+          std::unordered_map<std::size_t, std::size_t> &degreeCountMap, std::size_t &maxDegree, mxx::comm &comm)
       {
-#ifdef BENCHMARK_CONN
-        mxx::section_timer timer(std::cerr, comm);
-#endif
-
-        const int SRC = 1, DEST = 0;  //Reverse the layers to avoid sorting during relabeling vertices
-
-        const int sampler = 11;
-
-        //Ensure the block decomposition of edgeList
-        mxx::distribute_inplace(edgeList, comm);
-
-        //Sort by source, dest vertex
-        mxx::sort(edgeList.begin(), edgeList.end(), conn::utils::TpleComp2Layers<SRC,DEST>(), comm);
-
-        //Map to hold degree frequency
-        std::unordered_map<std::size_t, std::size_t> degreeCountMap;
-
-        std::size_t maxDegree = 0;
-
         //Vector to hold boundary vertex degrees
         std::vector<std::pair<E,E>> boundaryVertexDegrees;
 
-        for(auto it = edgeList.begin(); it != edgeList.end();)
+        for(auto it = sortedList.begin(); it != sortedList.end();)
         {
-          auto equalSrcRange = conn::utils::findRange(it, edgeList.end(), *it, conn::utils::TpleComp<SRC>()); 
+          auto equalSrcRange = conn::utils::findRange(it, sortedList.end(), *it, conn::utils::TpleComp<VERTEX>()); 
 
-          //A vertex may have duplicate destination vertices, ignore them
-          auto uniqueDestVerticeIter = std::unique(equalSrcRange.first, equalSrcRange.second);
+          std::size_t currentDegree = bucketDegree(equalSrcRange.first, equalSrcRange.second);
 
-          auto currentDegree = std::distance(equalSrcRange.first, uniqueDestVerticeIter);
-
-          if(equalSrcRange.first == edgeList.begin())   //First bucket
-            boundaryVertexDegrees.emplace_back(std::get<SRC>(*it), currentDegree);
-          else if(equalSrcRange.second == edgeList.end() && equalSrcRange.first != edgeList.begin())   //Last bucket (and different from first bucket)
-            boundaryVertexDegrees.emplace_back(std::get<SRC>(*it), currentDegree);
+          if(equalSrcRange.first == sortedList.begin())   //First bucket
+            boundaryVertexDegrees.emplace_back(std::get<VERTEX>(*it), currentDegree);
+          else if(equalSrcRange.second == sortedList.end() && equalSrcRange.first != sortedList.begin())   //Last bucket (and different from first bucket)
+            boundaryVertexDegrees.emplace_back(std::get<VERTEX>(*it), currentDegree);
           else
           {
             //This bucket is completely local to this rank
@@ -133,11 +114,11 @@ namespace conn
         {
           const int SRC = 0, COUNT = 1;
 
-          for(auto it = boundaryVertexDegrees.begin(); it != boundaryVertexDegrees.end();)
+          for(auto it = globalBoundaryVertexDegrees.begin(); it != globalBoundaryVertexDegrees.end();)
           {
             auto equalSrcRange = conn::utils::findRange(it, globalBoundaryVertexDegrees.end(), *it, conn::utils::TpleComp<SRC>());
           
-            auto currentDegree = std::accumulate(equalSrcRange.first, equalSrcRange.second, 0, [&](const E &p1, const std::pair<E,E> &p2){
+            std::size_t currentDegree = std::accumulate(equalSrcRange.first, equalSrcRange.second, (std::size_t) 0, [&](const std::size_t &p1, const std::pair<E,E> &p2){
                 return p1 + std::get<COUNT>(p2);
                 });
 
@@ -149,6 +130,83 @@ namespace conn
             it = equalSrcRange.second;
           }
         }
+      }
+
+    /**
+     * @brief                   Decides if its optimal to run BFS iteration based on the degree distribution
+     * @param[in]  edgeList     distributed vector of edges
+     * @param[in]  storage      bothWays if each edge is present both ways in the edgeList vector,
+     *                          halfEdges if each edge is present once
+     * @return                  true if BFS should be executed, false otherwise
+     * @NOTE                    edgeList is left sorted by <DEST, SRC> in both modes
+     */
+    template <typename E>
+      bool runBFSDecision(std::vector<std::pair<E,E>> &edgeList, mxx::comm &comm,
+          conn::graphGen::edgeStorage storage = conn::graphGen::edgeStorage::bothWays)
+      {
+#ifdef BENCHMARK_CONN
+        mxx::section_timer timer(std::cerr, comm);
+#endif
+
+        const int SRC = 1, DEST = 0;  //Reverse the layers to avoid sorting during relabeling vertices
+
+        const int sampler = 11;
+
+        //Ensure the block decomposition of edgeList
+        mxx::distribute_inplace(edgeList, comm);
+
+        //Map to hold degree frequency
+        std::unordered_map<std::size_t, std::size_t> degreeCountMap;
+
+        std::size_t maxDegree = 0;
+
+        //A vertex may have duplicate destination vertices, ignore them
+        auto uniqueBucketSize = [](typename std::vector<std::pair<E,E>>::iterator first, typename std::vector<std::pair<E,E>>::iterator last){
+          return (std::size_t) std::distance(first, std::unique(first, last));
+        };
+
+        if(storage == conn::graphGen::edgeStorage::bothWays)
+        {
+          //Sort by source, dest vertex (already done if duplicates were removed)
+          if(!mxx::is_sorted(edgeList.begin(), edgeList.end(), conn::utils::TpleComp2Layers<SRC,DEST>(), comm))
+            mxx::sort(edgeList.begin(), edgeList.end(), conn::utils::TpleComp2Layers<SRC,DEST>(), comm);
+
+          accumulateDegreeFrequency<SRC>(edgeList, uniqueBucketSize, degreeCountMap, maxDegree, comm);
+        }
+        else
+        {
+          //Each edge contributes to the degree of both its endpoints, so count the
+          //unique neighbors seen through either layer as partial degrees, and add them up
+          std::vector<std::pair<E,E>> vertexPartialDegrees;
+
+          //Neighbors listed in the other layer (sorted by DEST first so that we finish sorted by SRC)
+          mxx::sort(edgeList.begin(), edgeList.end(), conn::utils::TpleComp2Layers<DEST,SRC>(), comm);
+          for(auto it = edgeList.begin(); it != edgeList.end();)
+          {
+            auto equalRange = conn::utils::findRange(it, edgeList.end(), *it, conn::utils::TpleComp<DEST>()); 
+            vertexPartialDegrees.emplace_back(std::get<DEST>(*it), uniqueBucketSize(equalRange.first, equalRange.second));
+            it = equalRange.second;
+          }
+
+          mxx::sort(edgeList.begin(), edgeList.end(), conn::utils::TpleComp2Layers<SRC,DEST>(), comm);
+          for(auto it = edgeList.begin(); it != edgeList.end();)
+          {
+            auto equalRange = conn::utils::findRange(it, edgeList.end(), *it, conn::utils::TpleComp<SRC>()); 
+            vertexPartialDegrees.emplace_back(std::get<SRC>(*it), uniqueBucketSize(equalRange.first, equalRange.second));
+            it = equalRange.second;
+          }
+
+          //Bring the partial degrees of a vertex together
+          const int VERTEX = 0, COUNT = 1;
+          mxx::distribute_inplace(vertexPartialDegrees, comm);
+          mxx::sort(vertexPartialDegrees.begin(), vertexPartialDegrees.end(), conn::utils::TpleComp<VERTEX>(), comm);
+
+          accumulateDegreeFrequency<VERTEX>(vertexPartialDegrees, [](typename std::vector<std::pair<E,E>>::iterator first, typename std::vector<std::pair<E,E>>::iterator last){
+              return std::accumulate(first, last, (std::size_t) 0, [](const std::size_t &d, const std::pair<E,E> &p){
+                return d + std::get<COUNT>(p);
+                });
+              }, degreeCountMap, maxDegree, comm);
+        }
         
         maxDegree = mxx::allreduce(maxDegree, mxx::max<std::size_t>(), comm);
 
@@ -194,6 +252,37 @@ namespace conn
         return gbDecision == 1;
       }
 
+    /**
+     * @brief                         Decides, after a BFS run, if another BFS over the same matrix should be
+     *                                executed or the remaining graph should go to coloring
+     * @param[in] residualVertices    count of unvisited vertices with edges (see bfsSupport::residualDegreeSummary)
+     * @param[in] residualDegreeSum   sum of their degrees
+     * @param[in] maxResidualDegree   maximum degree among them
+     * @param[in] totalDegreeSum      sum of the degrees before the first BFS
+     * @param[in] hubRatio            another BFS needs a vertex with this many times the mean residual degree
+     * @param[in] minResidualFraction another BFS needs at least this fraction of the edges left
+     * @return                        true if another BFS should be executed
+     * @details                       A hub among the remaining vertices signals a large component, which
+     *                                the next BFS (started from the hub) removes in a few SpMVs. Without a hub,
+     *                                or with few edges left, coloring the remaining edges is cheaper
+     */
+    inline bool runNextBFSDecision(std::size_t residualVertices, std::size_t residualDegreeSum, std::size_t maxResidualDegree,
+        std::size_t totalDegreeSum, const mxx::comm &comm, double hubRatio = 8.0, double minResidualFraction = 0.05)
+    {
+      if(residualVertices == 0)
+        return false;
+
+      double meanResidualDegree = (double) residualDegreeSum / residualVertices;
+      double residualFraction = totalDegreeSum > 0 ? (double) residualDegreeSum / totalDegreeSum : 0.0;
+
+      bool decision = maxResidualDegree >= hubRatio * meanResidualDegree && residualFraction >= minResidualFraction;
+
+      LOG_IF(!comm.rank(), INFO) << "Residual graph : edge fraction -> " << residualFraction << ", max/mean degree -> " 
+        << maxResidualDegree / meanResidualDegree << (decision ? ", running another BFS" : ", switching to coloring"); 
+
+      return decision;
+    }
+
   }
 }
  
@@ -0,0 +1,217 @@
+/*
+ * Copyright 2016 Georgia Institute of Technology
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    memoryPlanner.hpp
+ * @ingroup dynamic
+ * @brief   Chooses the stages and their settings which fit in a per rank memory budget
+ *
+ * Copyright (c) 2016 Georgia Institute of Technology. All Rights Reserved.
+ */
+
+#ifndef MEMORY_PLANNER_HPP
+#define MEMORY_PLANNER_HPP
+
+//Includes
+#include <mpi.h>
+#include <vector>
+#include <tuple>
+#include <algorithm>
+#include <string>
+
+//Own includes
+#include "graphGen/common/utils.hpp"
+#include "utils/packedId.hpp"
+
+//External includes
+#include "extutils/logging.hpp"
+#include "mxx/comm.hpp"
+#include "mxx/reduction.hpp"
+
+namespace conn
+{
+  namespace dynamic
+  {
+
+    /**
+     * @brief     settings chosen by planExecution(), and the estimated peak bytes per rank of each stage
+     */
+    struct executionPlan
+    {
+      bool runBFS;
+      bool packedIds;
+
+      //Extra memory for each coloring sort, 0 for the regular sort
+      std::size_t sortBudget;
+
+      bool compressStable;
+
+      std::size_t edgeListBytes;
+      std::size_t bfsBytes;
+      std::size_t cclBytes;
+
+      //Largest of the above, over the stages which run
+      std::size_t peakBytes;
+
+      bool fits;
+
+      //False if the coloring tuples alone exceed the budget, no sort budget can help then
+      bool feasible;
+    };
+
+    /**
+     * @brief                 smallest sort budget worth a bounded memory sort
+     * @details               boundedMemorySort splits its budget in thirds and each round sends
+     *                        a third / p elements to every rank, so this keeps at least
+     *                        minRoundTuples tuples per destination in a round. A smaller budget
+     *                        would take about one round of collectives per local tuple
+     * @param[in] tupleBytes  bytes of one coloring tuple
+     */
+    inline std::size_t minSortBudget(std::size_t tupleBytes, const mxx::comm &comm)
+    {
+      const std::size_t minRoundTuples = 256;
+
+      return 3 * minRoundTuples * comm.size() * tupleBytes;
+    }
+
+    /**
+     * @brief                     estimates the memory of the stages from the edge count and the id width,
+     *                            and picks the settings which keep them within the budget
+     * @param[in] edgeList        deduplicated edge list, ids need not be contiguous yet
+     * @param[in] runBFS          BFS stage as chosen by runBFSDecision
+     * @param[in] memoryBudget    bytes available to each rank
+     * @param[in] laccEngine      the remaining components are labeled on the BFS matrix, which is then
+     *                            built even without BFS runs, and no coloring follows
+     * @details                   Per rank estimates, with m the largest local edge count and W the id width
+     *                              edge list  : 2W m
+     *                              BFS        : edge list, and two copies of the integer CombBLAS matrix
+     *                                           in the bfsSupport constructor (DistEdgeList and the matrix,
+     *                                           or the matrix and its transpose), 2W per nonzero each
+     *                              ccl        : edge list and the tuples during construction, then the
+     *                                           tuples and a sort buffer of the same size in each iteration
+     *                            The settings are tried in order till the peak fits
+     *                              1. skip BFS, the largest stage
+     *                              2. pack the vertex ids of coloring in 5 or 6 bytes
+     *                              3. sort the tuples in rounds within the remaining memory, with the
+     *                                 stable tuples compressed to leave room for the rounds. The sort
+     *                                 budget is at least minSortBudget, even if the peak exceeds the budget
+     *                            The plan is infeasible if the tuples alone exceed the budget.
+     *                            None of the settings apply to laccEngine, its peak is the BFS matrix
+     */
+    template <typename E>
+      executionPlan planExecution(const std::vector<std::pair<E,E>> &edgeList, bool runBFS, std::size_t memoryBudget,
+          const mxx::comm &comm, conn::graphGen::edgeStorage storage = conn::graphGen::edgeStorage::bothWays,
+          bool laccEngine = false)
+      {
+        bool halfEdges = (storage == conn::graphGen::edgeStorage::halfEdges);
+
+        std::size_t m = mxx::allreduce(edgeList.size(), mxx::max<std::size_t>(), comm);
+        std::size_t globalEdges = mxx::allreduce(edgeList.size(), comm);
+
+        //Vertex count is not known before the ids are compacted, every edge adds at most two vertices
+        int packedBytes = conn::utils::packedIdBytes(2 * globalEdges);
+
+        //Implied reverse edges become matrix nonzeros, and at most one self tuple per edge in ccl
+        std::size_t nonZeros = halfEdges ? 2 * m : m;
+        std::size_t tuples = halfEdges ? 2 * m : m;
+
+        executionPlan plan;
+
+        plan.runBFS = runBFS;
+        plan.packedIds = false;
+        plan.sortBudget = 0;
+        plan.compressStable = false;
+        plan.feasible = true;
+
+        plan.edgeListBytes = 2 * sizeof(E) * m;
+        plan.bfsBytes = plan.edgeListBytes + 2 * (2 * sizeof(E) * nonZeros);
+
+        auto cclEstimate = [&]()
+        {
+          std::size_t idBytes = plan.packedIds ? packedBytes : sizeof(E);
+          std::size_t tupleBytes = 3 * idBytes * tuples;
+
+          //Edge list is converted to the packed ids before ccl is constructed
+          std::size_t inputBytes = plan.packedIds ? plan.edgeListBytes + 2 * idBytes * m : plan.edgeListBytes;
+          std::size_t sortBytes = plan.sortBudget > 0 ? plan.sortBudget : tupleBytes;
+
+          return std::max(inputBytes + tupleBytes, tupleBytes + sortBytes);
+        };
+
+        auto peakEstimate = [&]()
+        {
+          plan.cclBytes = cclEstimate();
+          plan.peakBytes = std::max(plan.runBFS ? plan.bfsBytes : plan.edgeListBytes, plan.cclBytes);
+
+          return plan.peakBytes;
+        };
+
+        if(laccEngine)
+        {
+          plan.cclBytes = 0;
+          plan.peakBytes = plan.bfsBytes;
+          plan.fits = plan.peakBytes <= memoryBudget;
+
+          return plan;
+        }
+
+        if(peakEstimate() > memoryBudget && plan.runBFS)
+          plan.runBFS = false;
+
+        if(peakEstimate() > memoryBudget && packedBytes < (int) sizeof(E))
+          plan.packedIds = true;
+
+        if(peakEstimate() > memoryBudget)
+        {
+          std::size_t idBytes = plan.packedIds ? packedBytes : sizeof(E);
+          std::size_t tupleBytes = 3 * idBytes * tuples;
+
+          if(tupleBytes >= memoryBudget)
+            plan.feasible = false;
+          else
+          {
+            //Whatever remains next to the tuples, but enough for the rounds to make progress
+            plan.sortBudget = std::max(memoryBudget - tupleBytes, minSortBudget(3 * idBytes, comm));
+            plan.compressStable = true;
+          }
+        }
+
+        plan.fits = peakEstimate() <= memoryBudget;
+
+        return plan;
+      }
+
+    /**
+     * @brief     logs the chosen settings and the estimates on rank 0
+     */
+    inline void printExecutionPlan(const executionPlan &plan, std::size_t memoryBudget, const mxx::comm &comm)
+    {
+      LOG_IF(comm.rank() == 0, INFO) << "Execution plan for " << (memoryBudget >> 20) << " MB per rank";
+      LOG_IF(comm.rank() == 0, INFO) << "Estimated MB per rank : edge list -> " << (plan.edgeListBytes >> 20)
+        << ", BFS -> " << (plan.bfsBytes >> 20) << ", coloring -> " << (plan.cclBytes >> 20);
+      LOG_IF(comm.rank() == 0, INFO) << "BFS -> " << (plan.runBFS ? "yes" : "no")
+        << ", packed ids -> " << (plan.packedIds ? "yes" : "no")
+        << ", sort budget (KB) -> " << (plan.sortBudget > 0 ? std::to_string(plan.sortBudget >> 10) : "none")
+        << ", compressed stable tuples -> " << (plan.compressStable ? "yes" : "no");
+
+      LOG_IF(comm.rank() == 0 && !plan.fits, INFO) << "WARNING: estimated peak of " << (plan.peakBytes >> 20) << " MB per rank exceeds the budget"
+        << (plan.feasible ? "" : ", the coloring tuples alone do not fit");
+    }
+
+  }
+}
+
+#endif
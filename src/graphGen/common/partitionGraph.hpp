@@ -0,0 +1,245 @@
+/*
+ * Copyright 2016 Georgia Institute of Technology
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    partitionGraph.hpp
+ * @ingroup graphGen
+ * @brief   Lightweight distributed graph partitioner. Vertices are assigned to ranks using
+ *          size constrained label propagation, to reduce the edges between ranks before
+ *          the connectivity computation.
+ *
+ * Copyright (c) 2016 Georgia Institute of Technology. All Rights Reserved.
+ */
+
+#ifndef GRAPH_PARTITION_HPP
+#define GRAPH_PARTITION_HPP
+
+//Includes
+#include <mpi.h>
+#include <iostream>
+#include <algorithm>
+
+//Own includes
+#include "utils/commonfuncs.hpp"
+#include "graphGen/common/utils.hpp"
+#include "graphGen/common/reduceIds.hpp"
+#include "graphGen/common/reorderIds.hpp"
+#include "hash/invertible_hash.hpp"
+
+//External includes
+#include "mxx/distribution.hpp"
+#include "mxx/partition.hpp"
+#include "mxx/sort.hpp"
+#include "mxx/reduction.hpp"
+#include "extutils/logging.hpp"
+
+namespace conn
+{
+  namespace graphGen
+  {
+
+    /**
+     * @brief                     Partitions the graph across the ranks to reduce the cut edges
+     * @param[in,out] edgeList    distributed vector of edges, ids in [0, nVertices) (see reduceVertexIds)
+     * @param[in] epsilon         allowed imbalance, each part holds at most (1 + epsilon) * mean edges
+     * @param[in] rounds          maximum count of refinement rounds
+     * @details                   Parts are weighted by the degree of their vertices, as edges (and
+     *                            later tuples) are the load of the connectivity engines.
+     *                            1. Initial parts cut the id range into blocks of equal degree sum
+     *                            2. Label propagation over part labels, each vertex moves to the part
+     *                               holding most of its neighbors if that gains cut edges and the part
+     *                               has room. Room of each part is split evenly among the ranks at the
+     *                               start of a round, so no part overflows without coordination
+     *                            3. Vertices are relabeled so that part r holds a contiguous id range,
+     *                               and each edge is sent to the rank owning the part of its source
+     *                            The edgeList is left unbalanced within epsilon, a following
+     *                            distribute_inplace only moves the boundary edges.
+     *                            Edge cut and imbalance of the partition are reported
+     * @return                    count of the ids in the range of each rank. Engines which take it as
+     *                            their ownership of the ids (fastSV, rmaUnionFind) then find the edges of
+     *                            each vertex on its owner already. Block decomposed ownership would move
+     *                            the parts back across the ranks
+     */
+    template <typename E>
+      std::vector<std::size_t> partitionVertices(std::vector<std::pair<E,E>> &edgeList, std::size_t nVertices, const mxx::comm &comm,
+          edgeStorage storage = edgeStorage::bothWays, double epsilon = 0.05, int rounds = 10)
+      {
+        const int SRC = 0, DEST = 1;
+        const int p = comm.size();
+
+        mxx::partition::block_decomposition<std::size_t> part(nVertices, p, comm.rank());
+        std::size_t offset = part.excl_prefix_size();
+
+        auto adjacency = ownerAdjacency(edgeList, nVertices, comm, storage);
+        auto neighbors = uniqueNeighbors(adjacency);
+
+        //Degree of each local vertex
+        std::vector<std::size_t> degree(part.local_size(), 0);
+        for(auto &e : adjacency)
+          degree[std::get<SRC>(e) - offset]++;
+
+        std::size_t totalWeight = mxx::allreduce(adjacency.size(), std::plus<std::size_t>(), comm);
+        std::size_t weightBefore = mxx::exscan(adjacency.size(), std::plus<std::size_t>(), comm);
+        if(!comm.rank()) weightBefore = 0;
+
+        //Initial parts, blocks of equal degree sum
+        std::vector<int> labels(part.local_size());
+        for(std::size_t i = 0; i < labels.size(); i++)
+        {
+          labels[i] = totalWeight > 0 ? std::min(p - 1, (int) ((weightBefore * p) / totalWeight)) : 0;
+          weightBefore += degree[i];
+        }
+
+        auto partWeights = [&]()
+        {
+          std::vector<std::size_t> w(p, 0);
+          for(std::size_t i = 0; i < labels.size(); i++)
+            w[labels[i]] += degree[i];
+          return mxx::allreduce(w, std::plus<std::size_t>(), comm);
+        };
+
+        std::size_t capacity = (1.0 + epsilon) * totalWeight / p + 1;
+        int roundsExecuted = 0;
+
+        for(int r = 0; r < rounds; r++)
+        {
+          auto weights = partWeights();
+
+          //My share of the room left in each part
+          std::vector<std::size_t> quota(p, 0);
+          for(int q = 0; q < p; q++)
+            quota[q] = weights[q] < capacity ? (capacity - weights[q]) / p : 0;
+
+          auto bestPart = [&](E u, const std::vector<std::pair<int, std::size_t>> &histogram, int current)
+          {
+            //Half of the vertices update in a round, picked by a hash rather than the id parity,
+            //as the members of a cluster often share the parity and would swap parts in lockstep
+            uint64_t h = u;
+            conn::graphGen::hash_64(h);
+            if((h + r) % 2)
+              return current;
+
+            std::size_t currentCount = 0;
+            auto cur = std::lower_bound(histogram.begin(), histogram.end(), std::make_pair(current, (std::size_t) 0));
+            if(cur != histogram.end() && cur->first == current)
+              currentCount = cur->second;
+
+            std::size_t w = degree[u - offset];
+            int best = current;
+            std::size_t bestCount = currentCount;
+
+            for(auto &bucket : histogram)
+              if(bucket.second > bestCount && quota[bucket.first] >= w)
+              {
+                best = bucket.first;
+                bestCount = bucket.second;
+              }
+
+            if(best != current)
+              quota[best] -= w;
+
+            return best;
+          };
+
+          std::size_t moved = labelPropagationRound(adjacency, neighbors, labels, nVertices, bestPart, comm);
+          roundsExecuted++;
+
+          if(moved == 0)
+            break;
+        }
+
+        //Partition quality
+        auto weights = partWeights();
+        double imbalance = totalWeight > 0 ? (double) *std::max_element(weights.begin(), weights.end()) * p / totalWeight : 1.0;
+
+        std::size_t localCut = 0;
+        {
+          auto neighborParts = conn::utils::blockLookup(neighbors, labels, nVertices, comm);
+          for(auto &e : adjacency)
+          {
+            auto pos = std::lower_bound(neighbors.begin(), neighbors.end(), std::get<DEST>(e));
+            if(neighborParts[std::distance(neighbors.begin(), pos)] != labels[std::get<SRC>(e) - offset])
+              localCut++;
+          }
+        }
+        std::size_t cut = mxx::allreduce(localCut, std::plus<std::size_t>(), comm);
+
+        double cutBefore = cutEdgeFraction(edgeList, nVertices, comm);
+
+        std::vector<std::pair<E,E>>().swap(adjacency);
+        std::vector<E>().swap(neighbors);
+        std::vector<std::size_t>().swap(degree);
+
+        //Relabel, part r gets the r'th contiguous range of ids
+        std::vector<std::pair<E,E>> order;
+        order.reserve(labels.size());
+
+        for(std::size_t i = 0; i < labels.size(); i++)
+          order.emplace_back(labels[i], offset + i);
+
+        std::vector<std::size_t> partSizes(p, 0);
+        for(auto &l : labels)
+          partSizes[l]++;
+        partSizes = mxx::allreduce(partSizes, std::plus<std::size_t>(), comm);
+
+        std::vector<int>().swap(labels);
+
+        mxx::sort(order.begin(), order.end(), comm);
+
+        std::size_t localCount = order.size();
+        std::size_t exScanCount = mxx::exscan(localCount, std::plus<std::size_t>(), comm);
+        if(!comm.rank()) exScanCount = 0;
+
+        std::vector<std::pair<E,E>> idMap;
+        idMap.reserve(order.size());
+
+        for(std::size_t i = 0; i < order.size(); i++)
+          idMap.emplace_back(std::get<1>(order[i]), exScanCount + i);
+
+        std::vector<std::pair<E,E>>().swap(order);
+
+        mxx::sort(idMap.begin(), idMap.end(), conn::utils::TpleComp<0>(), comm);
+
+        //relabelLayer expects a non-empty edgeList on every rank
+        mxx::distribute_inplace(edgeList, comm);
+
+        relabelLayer<DEST>(edgeList, idMap, comm);
+        relabelLayer<SRC>(edgeList, idMap, comm);
+
+        //First id of each part, except the first part
+        std::vector<E> splitters(p - 1);
+        std::size_t prefix = 0;
+        for(int q = 0; q < p - 1; q++)
+        {
+          prefix += partSizes[q];
+          splitters[q] = prefix;
+        }
+
+        mxx::all2all_func(edgeList, [&](const std::pair<E,E> &e){
+            return (int) std::distance(splitters.begin(), std::upper_bound(splitters.begin(), splitters.end(), std::get<SRC>(e)));
+            }, comm);
+
+        LOG_IF(comm.rank() == 0, INFO) << "Graph partitioned, refinement rounds -> " << roundsExecuted
+          << ", edge cut -> " << cut << " (" << (totalWeight > 0 ? (double) cut / totalWeight : 0.0) << " of edges, "
+          << cutBefore << " with block ids), imbalance max/mean -> " << imbalance;
+
+        return partSizes;
+      }
+
+  }
+}
+
+#endif
@@ -113,23 +113,190 @@ namespace conn
         }
       }
 
+    /**
+     * @brief   edge generator with its ids relabeled as permuteVectorIds does, chunk by chunk
+     */
+    template <typename Source>
+      class permutedEdgeSource
+      {
+        private:
+
+          Source &source;
+
+        public:
+
+          using edgeType = typename Source::edgeType;
+
+          permutedEdgeSource(Source &source) : source(source) {}
+
+          std::size_t sizeHint() const
+          {
+            return source.sizeHint();
+          }
+
+          bool next(std::vector<std::pair<edgeType, edgeType>> &chunk)
+          {
+            if(!source.next(chunk))
+              return false;
+
+            permuteVectorIds(chunk);
+
+            return true;
+          }
+      };
+
+    /**
+     * @brief                   Replaces the ids in one layer of the edgeList using a distributed id map
+     * @tparam     LAYER        layer of the edge to relabel
+     * @param[in]  idMap        distributed vector of <old id, new id> pairs, globally sorted by old id
+     *                          and without duplicates
+     * @details                 Map entries are routed to the rank holding the first occurrence of their
+     *                          old id (splitters are the last ids of each rank), then merged with the locally 
+     *                          sorted edges. An id which spans several ranks gets its new id forwarded to the 
+     *                          following ranks through exscan
+     */
+    template <int LAYER, typename E>
+      void relabelLayer(std::vector<std::pair<E,E>> &edgeList, std::vector<std::pair<E,E>> idMap, const mxx::comm &comm)
+      {
+        const int OLD = 0, NEW = 1;
+
+        //Marks a missing mapping
+        const E MAX = std::numeric_limits<E>::max();
+
+        if(!mxx::is_sorted(edgeList.begin(), edgeList.end(), conn::utils::TpleComp<LAYER>(), comm))
+          mxx::sort(edgeList.begin(), edgeList.end(), conn::utils::TpleComp<LAYER>(), comm);
+
+        //Last id of each rank, except the last rank
+        auto splitters = mxx::allgather(std::get<LAYER>(edgeList.back()), comm);
+        splitters.pop_back();
+
+        mxx::all2all_func(idMap, [&](const std::pair<E,E> &m){
+            return (int) std::distance(splitters.begin(), std::lower_bound(splitters.begin(), splitters.end(), std::get<OLD>(m)));
+            }, comm);
+
+        std::sort(idMap.begin(), idMap.end(), conn::utils::TpleComp<OLD>());
+
+        //Mapping of my last id, if I hold it, is forwarded to the ranks on the right
+        std::pair<E,E> lastMapping(MAX, MAX);
+        auto lastIt = std::lower_bound(idMap.begin(), idMap.end(), std::get<LAYER>(edgeList.back()), conn::utils::TpleComp<OLD>());
+        if(lastIt != idMap.end() && std::get<OLD>(*lastIt) == std::get<LAYER>(edgeList.back()))
+          lastMapping = *lastIt;
+
+        auto prevMapping = mxx::exscan(lastMapping, [&](const std::pair<E,E> &a, const std::pair<E,E> &b){
+            return std::get<OLD>(b) != MAX ? b : a;
+            }, comm);
+
+        auto mapIt = idMap.begin();
+
+        for(auto it = edgeList.begin(); it != edgeList.end();)
+        {
+          //Edges with equal id in this layer
+          auto edgeListRange = conn::utils::findRange(it, edgeList.end(), *it, conn::utils::TpleComp<LAYER>()); 
+
+          E oldId = std::get<LAYER>(*it);
+          E newId;
+
+          while(mapIt != idMap.end() && std::get<OLD>(*mapIt) < oldId)
+            mapIt++;
+
+          if(mapIt != idMap.end() && std::get<OLD>(*mapIt) == oldId)
+            newId = std::get<NEW>(*mapIt);
+          else
+          {
+            //Only the first bucket can miss its mapping, it continues from the previous rank
+            assert(it == edgeList.begin() && comm.rank() > 0 && std::get<OLD>(prevMapping) == oldId);
+            newId = std::get<NEW>(prevMapping);
+          }
+
+          std::for_each(edgeListRange.first, edgeListRange.second, [&](std::pair<E,E> &e){
+              std::get<LAYER>(e) = newId;
+              });
+
+          it = edgeListRange.second;
+        }
+      }
+
+    /**
+     * @brief                         reduceVertexIds() for edge lists where each undirected edge is stored
+     *                                once, so a vertex may occur in only one of the two layers
+     * @details                       The unique ids of both layers are collected and globally sorted,
+     *                                their global rank is the new id. Each layer is then relabeled 
+     *                                separately using relabelLayer()
+     */
+    template <typename E>
+      void reduceVertexIdsHalfEdges(std::vector<std::pair<E,E>> &edgeList, std::size_t &uniqueVertexCount, const mxx::comm &comm)
+      {
+        const int SRC = 0, DEST = 1;
+
+        //Unique vertex ids from both the layers
+        std::vector<E> vertices;
+        vertices.reserve(2 * edgeList.size());
+
+        for(auto &e : edgeList)
+        {
+          vertices.push_back(std::get<SRC>(e));
+          vertices.push_back(std::get<DEST>(e));
+        }
+
+        std::sort(vertices.begin(), vertices.end());
+        vertices.erase(std::unique(vertices.begin(), vertices.end()), vertices.end());
+
+        mxx::distribute_inplace(vertices, comm);
+        mxx::sort(vertices.begin(), vertices.end(), comm);
+
+        //Duplicates are adjacent after the global sort
+        vertices.erase(std::unique(vertices.begin(), vertices.end()), vertices.end());
+
+        comm.with_subset(vertices.size() > 0, [&](const mxx::comm& comm){
+            E prevLastVertex = mxx::right_shift(vertices.back(), comm);
+            if(comm.rank() > 0 && prevLastVertex == vertices.front())
+              vertices.erase(vertices.begin());
+            });
+
+        std::size_t localUniqueVertexCount = vertices.size();
+        std::size_t exScanUniqueVertices = mxx::exscan(localUniqueVertexCount, std::plus<std::size_t>(), comm);
+        uniqueVertexCount = mxx::allreduce(localUniqueVertexCount, std::plus<std::size_t>(), comm);
+
+        if(!comm.rank()) exScanUniqueVertices = 0;
+
+        std::vector<std::pair<E,E>> idMap;
+        idMap.reserve(vertices.size());
+
+        for(std::size_t i = 0; i < vertices.size(); i++)
+          idMap.emplace_back(vertices[i], exScanUniqueVertices + i);
+
+        std::vector<E>().swap(vertices);
+
+        relabelLayer<DEST>(edgeList, idMap, comm);
+        relabelLayer<SRC>(edgeList, idMap, comm);
+      }
+
     /**
      * @brief                         Given a graph as list of edges, it updates all the vertex ids so
      *                                that they are contiguos from 0 to |V-1|
      * @param[in]  edgeList           distributed vector of edges
      * @param[out] uniqueVertexList   distributed array of original vertex ids (global index of vertex here is its new id)
+     * @param[in]  storage            halfEdges if each edge is present only once in the edgeList
      * @details                       (u, v) edge in the edgeList is transfromed to (x, y) if u is the xth 
      *                                element in the sorted order of all unique vertices, lly for v is yth 
      *                                Implemented using bucketing and all2all communication
      */
     template <typename E>
-      void reduceVertexIds(std::vector<std::pair<E,E>> &edgeList, std::size_t &uniqueVertexCount, const mxx::comm &comm)
+      void reduceVertexIds(std::vector<std::pair<E,E>> &edgeList, std::size_t &uniqueVertexCount, const mxx::comm &comm,
+          edgeStorage storage = edgeStorage::bothWays)
       {
         const int SRC = 0, DEST = 1;
 
         //Ensure the block decomposition of edgeList
         mxx::distribute_inplace(edgeList, comm);
 
+        //Both layers list the same vertex set only if reverse edges are stored
+        if(storage == edgeStorage::halfEdges)
+        {
+          reduceVertexIdsHalfEdges(edgeList, uniqueVertexCount, comm);
+          return;
+        }
+
         //Update the DEST layer of all the edges
         {
           //Globally sort all the edges by DEST layer
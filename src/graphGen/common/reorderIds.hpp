@@ -0,0 +1,310 @@
+/*
+ * Copyright 2016 Georgia Institute of Technology
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    reorderIds.hpp
+ * @ingroup graphGen
+ * @brief   Locality improving reordering of contiguous vertex ids. Vertices are clustered
+ *          using label propagation, and each cluster gets a contiguous range of new ids,
+ *          so that neighbors mostly land on the same rank and close in memory.
+ *
+ * Copyright (c) 2016 Georgia Institute of Technology. All Rights Reserved.
+ */
+
+#ifndef GRAPH_REORDER_HPP
+#define GRAPH_REORDER_HPP
+
+//Includes
+#include <mpi.h>
+#include <iostream>
+#include <algorithm>
+
+//Own includes
+#include "utils/commonfuncs.hpp"
+#include "utils/distArray.hpp"
+#include "graphGen/common/utils.hpp"
+#include "graphGen/common/reduceIds.hpp"
+
+//External includes
+#include "mxx/distribution.hpp"
+#include "mxx/partition.hpp"
+#include "mxx/sort.hpp"
+#include "mxx/reduction.hpp"
+#include "mxx/shift.hpp"
+#include "extutils/logging.hpp"
+
+namespace conn
+{
+  namespace graphGen
+  {
+
+    /**
+     * @brief                   fraction of the edges whose two endpoints are owned by different ranks
+     * @details                 Ownership is the block decomposition of the contiguous ids [0, nVertices),
+     *                          the layout of the BFS vectors, and roughly of the tuples after ccl sorts
+     *                          them by vertex id. Or the given ranges, see partitionVertices()
+     */
+    template <typename E>
+      double cutEdgeFraction(const std::vector<std::pair<E,E>> &edgeList, const conn::utils::rangePartition &part, const mxx::comm &comm)
+      {
+        const int SRC = 0, DEST = 1;
+
+        std::size_t localCut = std::count_if(edgeList.begin(), edgeList.end(), [&](const std::pair<E,E> &e){
+            return part.target_processor(std::get<SRC>(e)) != part.target_processor(std::get<DEST>(e));
+            });
+        std::size_t localTotal = edgeList.size();
+
+        std::size_t cut = mxx::allreduce(localCut, std::plus<std::size_t>(), comm);
+        std::size_t total = mxx::allreduce(localTotal, std::plus<std::size_t>(), comm);
+
+        return total > 0 ? (double) cut / total : 0.0;
+      }
+
+    template <typename E>
+      double cutEdgeFraction(const std::vector<std::pair<E,E>> &edgeList, std::size_t nVertices, const mxx::comm &comm)
+      {
+        return cutEdgeFraction(edgeList, conn::utils::rangePartition(nVertices, comm), comm);
+      }
+
+    /**
+     * @brief                   copies the edges in both directions to the rank owning their source vertex,
+     *                          by the block decomposition of [0, nVertices) or the given ranges
+     * @details                 The adjacency of each vertex is then complete on its owner, and is locally
+     *                          sorted by source. Used by the label propagation passes
+     */
+    template <typename E>
+      std::vector<std::pair<E,E>> ownerAdjacency(const std::vector<std::pair<E,E>> &edgeList, const conn::utils::rangePartition &part,
+          const mxx::comm &comm, edgeStorage storage = edgeStorage::bothWays)
+      {
+        const int SRC = 0, DEST = 1;
+
+        std::vector<std::pair<E,E>> adjacency(edgeList);
+
+        if(storage == edgeStorage::halfEdges)
+        {
+          adjacency.reserve(2 * edgeList.size());
+          for(auto &e : edgeList)
+            adjacency.emplace_back(std::get<DEST>(e), std::get<SRC>(e));
+        }
+
+        mxx::all2all_func(adjacency, [&](const std::pair<E,E> &e){
+            return part.target_processor(std::get<SRC>(e));
+            }, comm);
+
+        std::sort(adjacency.begin(), adjacency.end());
+
+        return adjacency;
+      }
+
+    template <typename E>
+      std::vector<std::pair<E,E>> ownerAdjacency(const std::vector<std::pair<E,E>> &edgeList, std::size_t nVertices,
+          const mxx::comm &comm, edgeStorage storage = edgeStorage::bothWays)
+      {
+        return ownerAdjacency(edgeList, conn::utils::rangePartition(nVertices, comm), comm, storage);
+      }
+
+    /**
+     * @brief                   one synchronous round of label propagation
+     * @param[in] adjacency     output of ownerAdjacency()
+     * @param[in] neighbors     sorted unique destination vertices of adjacency
+     * @param[in,out] labels    label of each vertex owned by this rank
+     * @param[in] choose        choose(vertex, histogram, currentLabel) returns the new label of a vertex,
+     *                          histogram lists <label, count> of its neighbors, sorted by label
+     * @return                  global count of the vertices whose label changed
+     */
+    template <typename E, typename L, typename ChooseFunc>
+      std::size_t labelPropagationRound(const std::vector<std::pair<E,E>> &adjacency, const std::vector<E> &neighbors,
+          std::vector<L> &labels, std::size_t nVertices, ChooseFunc choose, const mxx::comm &comm)
+      {
+        const int SRC = 0, DEST = 1;
+
+        mxx::partition::block_decomposition<std::size_t> part(nVertices, comm.size(), comm.rank());
+        std::size_t offset = part.excl_prefix_size();
+
+        auto neighborLabels = conn::utils::blockLookup(neighbors, labels, nVertices, comm);
+
+        std::vector<L> newLabels(labels);
+        std::vector<L> bucket;
+        std::vector<std::pair<L, std::size_t>> histogram;
+
+        for(auto it = adjacency.begin(); it != adjacency.end();)
+        {
+          auto range = conn::utils::findRange(it, adjacency.end(), *it, conn::utils::TpleComp<SRC>());
+          E u = std::get<SRC>(*it);
+
+          bucket.clear();
+          std::for_each(range.first, range.second, [&](const std::pair<E,E> &e){
+              auto pos = std::lower_bound(neighbors.begin(), neighbors.end(), std::get<DEST>(e));
+              bucket.push_back(neighborLabels[std::distance(neighbors.begin(), pos)]);
+              });
+
+          std::sort(bucket.begin(), bucket.end());
+
+          histogram.clear();
+          for(auto &l : bucket)
+          {
+            if(histogram.empty() || histogram.back().first != l)
+              histogram.emplace_back(l, 0);
+            histogram.back().second++;
+          }
+
+          newLabels[u - offset] = choose(u, histogram, labels[u - offset]);
+
+          it = range.second;
+        }
+
+        std::size_t localChanged = 0;
+        for(std::size_t i = 0; i < labels.size(); i++)
+          if(labels[i] != newLabels[i]) localChanged++;
+
+        labels.swap(newLabels);
+
+        return mxx::allreduce(localChanged, std::plus<std::size_t>(), comm);
+      }
+
+    /**
+     * @brief                   sorted unique destination vertices of the adjacency
+     */
+    template <typename E>
+      std::vector<E> uniqueNeighbors(const std::vector<std::pair<E,E>> &adjacency)
+      {
+        const int DEST = 1;
+
+        std::vector<E> neighbors;
+        neighbors.reserve(adjacency.size());
+
+        for(auto &e : adjacency)
+          neighbors.push_back(std::get<DEST>(e));
+
+        std::sort(neighbors.begin(), neighbors.end());
+        neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+
+        return neighbors;
+      }
+
+    /**
+     * @brief                     Reorders the contiguous vertex ids to improve locality
+     * @param[in,out] edgeList    distributed vector of edges, ids in [0, nVertices) (see reduceVertexIds)
+     * @param[in] rounds          maximum count of label propagation rounds
+     * @details                   1. Each vertex repeatedly adopts the most frequent label among its
+     *                               neighbors (ties keep the current label, else the smallest). Only half
+     *                               of the vertices, alternating by id parity, update in a round, which
+     *                               avoids the oscillation of fully synchronous updates
+     *                            2. Vertices are globally sorted by <cluster label, id>, and the sorted
+     *                               position is the new id
+     *                            The new ids are still a permutation of [0, nVertices), so the block
+     *                            decomposition keeps the same vertex count per rank; only the cut edges
+     *                            between ranks go down. Locality is reported as the fraction of cut edges
+     */
+    template <typename E>
+      void reorderVertexIds(std::vector<std::pair<E,E>> &edgeList, std::size_t nVertices, const mxx::comm &comm,
+          edgeStorage storage = edgeStorage::bothWays, int rounds = 5)
+      {
+        const int SRC = 0, DEST = 1;
+
+        mxx::partition::block_decomposition<std::size_t> part(nVertices, comm.size(), comm.rank());
+        std::size_t offset = part.excl_prefix_size();
+
+        double cutBefore = cutEdgeFraction(edgeList, nVertices, comm);
+
+        std::vector<E> labels(part.local_size());
+        for(std::size_t i = 0; i < labels.size(); i++)
+          labels[i] = offset + i;
+
+        int roundsExecuted = 0;
+
+        {
+          auto adjacency = ownerAdjacency(edgeList, nVertices, comm, storage);
+          auto neighbors = uniqueNeighbors(adjacency);
+
+          for(int r = 0; r < rounds; r++)
+          {
+            auto mostFrequent = [&](E u, const std::vector<std::pair<E, std::size_t>> &histogram, E current)
+            {
+              if((u + r) % 2)
+                return current;
+
+              //Histogram is sorted by label, so the first maximum is the smallest label
+              auto best = std::max_element(histogram.begin(), histogram.end(),
+                  [](const std::pair<E, std::size_t> &a, const std::pair<E, std::size_t> &b){ return a.second < b.second; });
+
+              auto cur = std::lower_bound(histogram.begin(), histogram.end(), std::make_pair(current, (std::size_t) 0));
+              if(cur != histogram.end() && cur->first == current && cur->second == best->second)
+                return current;
+
+              return best->first;
+            };
+
+            std::size_t changed = labelPropagationRound(adjacency, neighbors, labels, nVertices, mostFrequent, comm);
+            roundsExecuted++;
+
+            if(changed == 0)
+              break;
+          }
+        }
+
+        //Sort the vertices by <label, old id>
+        std::vector<std::pair<E,E>> order;
+        order.reserve(labels.size());
+
+        for(std::size_t i = 0; i < labels.size(); i++)
+          order.emplace_back(labels[i], offset + i);
+
+        std::vector<E>().swap(labels);
+
+        mxx::sort(order.begin(), order.end(), comm);
+
+        //Count of clusters, for the log
+        std::size_t localClusters = 0;
+        comm.with_subset(order.size() > 0, [&](const mxx::comm& comm){
+            E prevLabel = mxx::right_shift(std::get<0>(order.back()), comm);
+            for(std::size_t i = 0; i < order.size(); i++)
+              if((i == 0 && (comm.rank() == 0 || prevLabel != std::get<0>(order[i]))) || (i > 0 && std::get<0>(order[i-1]) != std::get<0>(order[i])))
+                localClusters++;
+            });
+        std::size_t nClusters = mxx::allreduce(localClusters, std::plus<std::size_t>(), comm);
+
+        std::size_t localCount = order.size();
+        std::size_t exScanCount = mxx::exscan(localCount, std::plus<std::size_t>(), comm);
+        if(!comm.rank()) exScanCount = 0;
+
+        //Build the <old id, new id> map
+        std::vector<std::pair<E,E>> idMap;
+        idMap.reserve(order.size());
+
+        for(std::size_t i = 0; i < order.size(); i++)
+          idMap.emplace_back(std::get<1>(order[i]), exScanCount + i);
+
+        std::vector<std::pair<E,E>>().swap(order);
+
+        mxx::sort(idMap.begin(), idMap.end(), conn::utils::TpleComp<0>(), comm);
+
+        //relabelLayer expects a non-empty edgeList on every rank
+        mxx::distribute_inplace(edgeList, comm);
+
+        relabelLayer<DEST>(edgeList, idMap, comm);
+        relabelLayer<SRC>(edgeList, idMap, comm);
+
+        double cutAfter = cutEdgeFraction(edgeList, nVertices, comm);
+
+        LOG_IF(comm.rank() == 0, INFO) << "Vertex ids reordered, label propagation rounds -> " << roundsExecuted
+          << ", clusters -> " << nClusters << ", cut edge fraction before -> " << cutBefore << ", after -> " << cutAfter;
+      }
+
+  }
+}
+
+#endif
@@ -26,6 +26,9 @@
 #ifndef GRAPH_UTILS_HPP
 #define GRAPH_UTILS_HPP
 
+//Includes
+#include <algorithm>
+
 //Own inlcudes
 #include "utils/commonfuncs.hpp"
 
@@ -33,12 +36,22 @@
 #include "extutils/logging.hpp"
 #include "mxx/reduction.hpp"
 #include "mxx/sort.hpp"
+#include "mxx/distribution.hpp"
 
 namespace conn 
 {
   namespace graphGen
   {
 
+    /**
+     * @brief     storage format of the undirected edges in a distributed edgeList
+     */
+    enum edgeStorage
+    {
+      bothWays,     //each undirected edge u--v is stored twice, as (u,v) and (v,u)
+      halfEdges     //each undirected edge is stored once, the reverse direction is implied
+    };
+
     /**
      * @details   Helper function to print the edgelist distribution
      *            across ranks during the algorithm's exection. Prints the min, mean and 
@@ -57,6 +70,55 @@ namespace conn
         LOG_IF(comm.rank() == 0, INFO) << "Distribution of edge list; min-mean-max : " << minLoad << sep << meanLoad << sep << maxLoad;
       }
 
+    /**
+     * @brief                 Removes self loops and duplicate edges from the distributed edgeList
+     * @param[in]  storage    with halfEdges, (u,v) and (v,u) are also duplicates, edges are 
+     *                        stored as (min, max) on return
+     * @details               The edgeList is globally sorted by <DEST, SRC>, duplicates are then adjacent 
+     *                        and removed through a linear scan (plus a check against the last edge
+     *                        of the previous rank). This is the same order runBFSDecision() and 
+     *                        reduceVertexIds() sort in, so the sort here replaces theirs rather than 
+     *                        adding a new one
+     * @return                global count of edges removed
+     */
+    template <typename E>
+      std::size_t removeDuplicateEdges(std::vector< std::pair<E,E> > &edgeList, mxx::comm &comm,
+          edgeStorage storage = edgeStorage::bothWays)
+      {
+        const int SRC = 0, DEST = 1;
+
+        std::size_t localSizeBefore = edgeList.size();
+
+        //Self loops don't affect connectivity
+        edgeList.erase(std::remove_if(edgeList.begin(), edgeList.end(), [](const std::pair<E,E> &e){
+              return std::get<SRC>(e) == std::get<DEST>(e);
+              }), edgeList.end());
+
+        if(storage == edgeStorage::halfEdges)
+          for(auto &e : edgeList)
+            if(std::get<SRC>(e) > std::get<DEST>(e))
+              std::swap(std::get<SRC>(e), std::get<DEST>(e));
+
+        mxx::distribute_inplace(edgeList, comm);
+        mxx::sort(edgeList.begin(), edgeList.end(), conn::utils::TpleComp2Layers<DEST,SRC>(), comm);
+
+        edgeList.erase(std::unique(edgeList.begin(), edgeList.end()), edgeList.end());
+
+        //First edge may repeat the last edge of the previous rank
+        comm.with_subset(edgeList.size() > 0, [&](const mxx::comm& comm){
+            auto prevLastEdge = mxx::right_shift(edgeList.back(), comm);
+            if(comm.rank() > 0 && prevLastEdge == edgeList.front())
+              edgeList.erase(edgeList.begin());
+            });
+
+        std::size_t localRemoved = localSizeBefore - edgeList.size();
+        std::size_t removed = mxx::allreduce(localRemoved, std::plus<std::size_t>(), comm);
+
+        LOG_IF(comm.rank() == 0, INFO) << "Self loops and duplicate edges removed -> " << removed;
+
+        return removed;
+      }
+
     /**
      * @brief     Helper function to confirm edges are represented in both directions
      * @note      Use while debugging or testing only
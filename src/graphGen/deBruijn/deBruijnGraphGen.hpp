@@ -76,11 +76,16 @@ namespace conn
          * @brief                 populates the edge list vector 
          * @param[in]   fileName
          * @param[out]  edgelist
+         * @param[in]   addReverseEdge  set to false for the half-edge (single direction) mode
+         * @details                     Both in- and out-neighbors are listed for each k-mer, so
+         *                              every edge is generated from both of its endpoints. In half-edge
+         *                              mode, only the copy with the smaller source k-mer is kept
          */
         template <typename E>
         void populateEdgeList( std::vector< std::pair<E, E> > &edgeList, 
             std::string &fileName,
-            const mxx::comm &comm)
+            const mxx::comm &comm,
+            bool addReverseEdge = true)
         {
           Timer timer;
 
@@ -125,14 +130,16 @@ namespace conn
             {
 
               auto d = minKmer(e).getData()[0];
-              edgeList.emplace_back(s, d);
+              if(addReverseEdge || s < d)
+                edgeList.emplace_back(s, d);
             }
 
             //Same procedure for the outgoing edges
             for(auto &e : tmpNeighborVector2)
             {
               auto d = minKmer(e).getData()[0];
-              edgeList.emplace_back(s, d);
+              if(addReverseEdge || s < d)
+                edgeList.emplace_back(s, d);
             }
           }
 
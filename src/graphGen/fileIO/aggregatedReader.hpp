@@ -0,0 +1,320 @@
+/*
+ * Copyright 2016 Georgia Institute of Technology
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    aggregatedReader.hpp
+ * @ingroup graphGen
+ * @brief   File input through a few aggregator ranks per node, shared with the
+ *          other ranks of the node through MPI shared memory
+ *
+ * Copyright (c) 2016 Georgia Institute of Technology. All Rights Reserved.
+ */
+
+#ifndef AGGREGATED_READER_HPP
+#define AGGREGATED_READER_HPP
+
+//Includes
+#include <mpi.h>
+#include <iostream>
+#include <string>
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+//External includes
+#include "mxx/comm.hpp"
+
+namespace conn
+{
+  namespace graphGen
+  {
+
+    /**
+     * @class                 conn::graphGen::nodeAggregatedFile
+     * @brief                 byte range of a file read once per node, by its aggregator ranks
+     * @details               The file is split among the nodes in proportion to their rank counts,
+     *                        and the span of a node among its ranks. Span of the node is read into a
+     *                        shared memory window in aligned blocks, block b by aggregator b % A, and
+     *                        each block is flagged once read. Aggregators read one of their blocks each
+     *                        time their own parsing moves to the next block, and keep reading while they
+     *                        wait on a block, so the reads overlap the parsing on every rank. Failed file
+     *                        operations abort the job, as the other ranks may wait on the blocks.
+     *                        All ranks of the node must construct it together
+     */
+    class nodeAggregatedFile
+    {
+      private:
+
+        //Communicator of the ranks sharing memory with us
+        MPI_Comm nodeComm;
+
+        //Communicator of all the readers, aborted on a failed file operation
+        MPI_Comm abortComm;
+
+        std::string filename;
+
+        //Open file of an aggregator, -1 on the other ranks
+        int fd;
+
+        //Next block read by this aggregator, steps by the aggregator count
+        std::size_t nextBlock;
+        int aggregators;
+
+        MPI_Win window;
+
+        int nodeRank, nodeSize;
+
+        //Aligned start of the node span in the file, and the count of blocks read
+        std::size_t spanStart, blockSize, blockCount;
+
+        //End of the bytes read, the node span and the overlap past it
+        std::size_t spanEnd;
+
+        //Read flags of the blocks, followed by the data
+        volatile uint8_t *flags;
+        const char *data;
+
+        std::size_t fileSize;
+
+        //Byte range of the file this rank parses
+        std::size_t rangeStart, rangeEnd;
+
+        //Blocks known to be read, from the first block this rank needs
+        std::size_t readyBlocks;
+
+        //Alignment of the file offsets and the buffer, needed for direct IO
+        static const std::size_t ALIGNMENT = 4096;
+
+        static std::size_t alignDown(std::size_t x) { return x / ALIGNMENT * ALIGNMENT; }
+        static std::size_t alignUp(std::size_t x) { return (x + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT; }
+
+        /**
+         * @brief     reports a failed operation on the file and aborts all the readers
+         */
+        void fail(const char *operation, const char *reason)
+        {
+          std::cerr << "Error: " << operation << " failed on " << filename << ", " << reason << std::endl;
+          MPI_Abort(abortComm, 1);
+        }
+
+        void fail(const char *operation, int error)
+        {
+          fail(operation, error ? std::strerror(error) : "unexpected end of file");
+        }
+
+        /**
+         * @brief     aggregator rank opens the file
+         */
+        void openFile(bool directIO)
+        {
+#ifdef O_DIRECT
+          if(directIO)
+            fd = open(filename.c_str(), O_RDONLY | O_DIRECT);
+#endif
+
+          //Direct IO is not supported by every file system
+          if(fd < 0)
+            fd = open(filename.c_str(), O_RDONLY);
+
+          if(fd < 0)
+            fail("open", errno);
+        }
+
+        /**
+         * @brief     aggregator rank reads its next block, and flags it
+         * @return    false if all its blocks are read
+         */
+        bool readNextBlock()
+        {
+          if(fd < 0 || nextBlock >= blockCount)
+            return false;
+
+          std::size_t b = nextBlock;
+          std::size_t done = 0;
+
+          //Short reads at the end of the file, full aligned lengths are requested for direct IO
+          while(spanStart + b * blockSize + done < fileSize && done < blockSize)
+          {
+            ssize_t bytes = pread(fd, const_cast<char *>(data) + b * blockSize + done, blockSize - done, spanStart + b * blockSize + done);
+
+            if(bytes < 0 && errno == EINTR)
+              continue;
+
+            if(bytes <= 0)
+              fail("pread", bytes < 0 ? errno : 0);
+
+            done += bytes;
+          }
+
+          MPI_Win_sync(window);
+          __atomic_store_n(flags + b, 1, __ATOMIC_RELEASE);
+
+          nextBlock += aggregators;
+
+          return true;
+        }
+
+      public:
+
+        /**
+         * @param[in] aggregators   count of ranks per node which read the file
+         * @param[in] blockSize     bytes per read, rounded to a multiple of 4096
+         * @param[in] directIO      bypass the page cache with O_DIRECT where supported
+         * @param[in] overlap       bytes read past the node span, to finish the last record
+         */
+        nodeAggregatedFile(const std::string &_filename, const mxx::comm &comm, int _aggregators,
+            std::size_t _blockSize, bool directIO, std::size_t overlap) : abortComm(comm), filename(_filename), fd(-1)
+        {
+          MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, comm.rank(), MPI_INFO_NULL, &nodeComm);
+          MPI_Comm_rank(nodeComm, &nodeRank);
+          MPI_Comm_size(nodeComm, &nodeSize);
+
+          aggregators = std::max(1, std::min(_aggregators, nodeSize));
+          blockSize = std::max(alignUp(_blockSize), alignUp(1));
+
+          //Size of the file, as seen by rank 0
+          if(comm.rank() == 0)
+          {
+            struct stat fileStat;
+            if(stat(filename.c_str(), &fileStat) != 0)
+              fail("stat", errno);
+
+            fileSize = fileStat.st_size;
+          }
+          MPI_Bcast(&fileSize, 1, MPI_UINT64_T, 0, comm);
+
+          //Position of the node ranks among all, through the leaders of the nodes
+          uint64_t firstSlot = 0, nodeRanks = nodeSize;
+
+          MPI_Comm leaderComm;
+          MPI_Comm_split(comm, nodeRank == 0 ? 0 : MPI_UNDEFINED, comm.rank(), &leaderComm);
+          if(nodeRank == 0)
+          {
+            MPI_Exscan(&nodeRanks, &firstSlot, 1, MPI_UINT64_T, MPI_SUM, leaderComm);
+
+            int leaderRank;
+            MPI_Comm_rank(leaderComm, &leaderRank);
+            if(leaderRank == 0)
+              firstSlot = 0;
+
+            MPI_Comm_free(&leaderComm);
+          }
+          MPI_Bcast(&firstSlot, 1, MPI_UINT64_T, 0, nodeComm);
+
+          auto slotOffset = [&](std::size_t slot) { return fileSize / comm.size() * slot + std::min<std::size_t>(slot, fileSize % comm.size()); };
+
+          spanEnd = std::min(fileSize, slotOffset(firstSlot + nodeSize) + overlap);
+
+          //One byte before the span tells if its first record is complete
+          spanStart = alignDown(firstSlot > 0 ? slotOffset(firstSlot) - 1 : 0);
+
+          rangeStart = slotOffset(firstSlot + nodeRank);
+          rangeEnd = slotOffset(firstSlot + nodeRank + 1);
+
+          blockCount = (spanEnd - spanStart + blockSize - 1) / blockSize;
+
+          //Flags are padded to keep the data aligned, one more alignment unit for the window base
+          std::size_t flagBytes = alignUp(blockCount);
+          MPI_Aint windowBytes = nodeRank == 0 ? flagBytes + blockCount * blockSize + ALIGNMENT : 0;
+
+          char *localBase;
+          MPI_Win_allocate_shared(windowBytes, 1, MPI_INFO_NULL, nodeComm, &localBase, &window);
+
+          MPI_Aint sharedBytes;
+          int dispUnit;
+          char *base;
+          MPI_Win_shared_query(window, 0, &sharedBytes, &dispUnit, &base);
+
+          base = reinterpret_cast<char *>(alignUp(reinterpret_cast<std::size_t>(base)));
+          flags = reinterpret_cast<volatile uint8_t *>(base);
+          data = base + flagBytes;
+
+          if(nodeRank == 0)
+            std::fill(base, base + flagBytes, 0);
+
+          MPI_Win_lock_all(MPI_MODE_NOCHECK, window);
+          MPI_Win_sync(window);
+          MPI_Barrier(nodeComm);
+          MPI_Win_sync(window);
+
+          readyBlocks = (rangeStart > spanStart ? rangeStart - 1 - spanStart : 0) / blockSize;
+
+          //Aggregators start with their first block, the rest follow their parsing
+          nextBlock = nodeRank;
+          if(nodeRank < aggregators)
+          {
+            openFile(directIO);
+            readNextBlock();
+          }
+        }
+
+        ~nodeAggregatedFile()
+        {
+          //Blocks the other ranks may still wait on
+          while(readNextBlock());
+
+          if(fd >= 0)
+            close(fd);
+
+          MPI_Win_unlock_all(window);
+          MPI_Barrier(nodeComm);
+          MPI_Win_free(&window);
+          MPI_Comm_free(&nodeComm);
+        }
+
+        std::size_t size() const { return fileSize; }
+        std::size_t begin() const { return rangeStart; }
+        std::size_t end() const { return rangeEnd; }
+
+        /**
+         * @brief     byte at the given file offset, waits till its block is read
+         * @details   Offsets past the overlap of the node span were never read, a record
+         *            which runs into them aborts all the readers
+         */
+        char at(std::size_t offset)
+        {
+          assert(offset >= spanStart && offset < fileSize);
+
+          if(offset >= spanEnd)
+            fail("parsing", "record longer than the overlap read past the node span");
+
+          std::size_t block = (offset - spanStart) / blockSize;
+
+          while(readyBlocks <= block)
+          {
+            //Keep reading our own blocks while waiting, ours may be the ones the others wait on
+            while(__atomic_load_n(flags + readyBlocks, __ATOMIC_ACQUIRE) == 0)
+              if(!readNextBlock())
+                MPI_Win_sync(window);
+
+            readyBlocks++;
+
+            //One more block of ours per block parsed
+            readNextBlock();
+          }
+
+          return data[offset - spanStart];
+        }
+    };
+
+  }
+}
+
+#endif
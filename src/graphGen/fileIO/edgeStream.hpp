@@ -0,0 +1,344 @@
+/*
+ * Copyright 2016 Georgia Institute of Technology
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    edgeStream.hpp
+ * @ingroup graphGen
+ * @brief   Reads the edge list from pipes or stdin, which can not be partitioned by byte ranges
+ *
+ * Copyright (c) 2016 Georgia Institute of Technology. All Rights Reserved.
+ */
+
+#ifndef EDGE_STREAM_HPP
+#define EDGE_STREAM_HPP
+
+//Includes
+#include <mpi.h>
+#include <vector>
+#include <string>
+#include <iostream>
+#include <algorithm>
+#include <cstdlib>
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+//Own includes
+#include "graphGen/common/timer.hpp"
+
+//External includes
+#include "extutils/logging.hpp"
+#include "mxx/comm.hpp"
+#include "mxx/reduction.hpp"
+
+namespace conn
+{
+  namespace graphGen
+  {
+
+    /**
+     * @class     conn::graphGen::EdgeStreamParser
+     * @brief     Builds the distributed edge list from sequential sources, such as named pipes or stdin
+     * @details   Rank i < count of sources is a reader of source i, "-" being stdin. A reader parses
+     *            its source in chunks, and sends the batches of edges to all the ranks round-robin.
+     *            Each reader has two send buffers, so it parses the next batch while the previous one is
+     *            in flight, and the ingestion keeps pace with the producer without a scratch file.
+     *            Reverse edges are added by the receivers, which halves the traffic
+     */
+    template<typename E>
+      class EdgeStreamParser
+      {
+        private:
+
+          //MPI communicator
+          mxx::comm comm;
+
+          //Switch to determine if reverse of each edge should be included as well
+          bool addReverseEdge;
+
+          //Reference to the distributed edge list
+          std::vector< std::pair<E,E> > &edgeList;
+
+          std::vector<std::string> sources;
+
+          //Edges per batch sent to a rank
+          std::size_t batchEdges;
+
+          //Bytes per read from the source
+          const static std::size_t CHUNK = 1UL << 20;
+
+          const static int BATCH_TAG = 17;
+
+          //Count of end markers received, one from each reader
+          int readersDone = 0;
+
+          //Edges parsed by this reader
+          std::size_t edgesRead = 0;
+
+          void appendBatch(const std::vector<E> &batch, std::size_t count)
+          {
+            for(std::size_t i = 0; i + 1 < count; i += 2)
+            {
+              edgeList.emplace_back(batch[i], batch[i+1]);
+              if(addReverseEdge)
+                edgeList.emplace_back(batch[i+1], batch[i]);
+            }
+          }
+
+          /**
+           * @brief     receives a batch, from any reader
+           * @param[in] wait    block till a batch arrives, else return if none is ready
+           * @return    true if a batch was received
+           */
+          bool receiveBatch(bool wait)
+          {
+            MPI_Status status;
+            int ready = 1;
+
+            if(wait)
+              MPI_Probe(MPI_ANY_SOURCE, BATCH_TAG, comm, &status);
+            else
+              MPI_Iprobe(MPI_ANY_SOURCE, BATCH_TAG, comm, &ready, &status);
+
+            if(!ready)
+              return false;
+
+            int bytes;
+            MPI_Get_count(&status, MPI_BYTE, &bytes);
+
+            std::vector<E> batch(bytes / sizeof(E));
+            MPI_Recv(batch.data(), bytes, MPI_BYTE, status.MPI_SOURCE, BATCH_TAG, comm, MPI_STATUS_IGNORE);
+
+            //Empty batch marks the end of a reader
+            if(bytes == 0)
+              readersDone++;
+            else
+              appendBatch(batch, batch.size());
+
+            return true;
+          }
+
+          /**
+           * @brief     parses a line of two integers separated by a space, comments begin with '%'
+           */
+          static bool parseLine(const char *first, const char *last, E &vertex1, E &vertex2)
+          {
+            if(first == last || *first == '%' || std::count(first, last, ' ') != 1)
+              return false;
+
+            char *next;
+            vertex1 = static_cast<E>(std::strtoll(first, &next, 10));
+            vertex2 = static_cast<E>(std::strtoll(next, nullptr, 10));
+
+            return true;
+          }
+
+          /**
+           * @brief     reports a failed operation on the source and aborts, the other ranks wait on its batches
+           */
+          void fail(const char *operation, const std::string &source)
+          {
+            std::cerr << "Error: " << operation << " failed on " << source << ", " << std::strerror(errno) << std::endl;
+            MPI_Abort(comm, 1);
+          }
+
+          /**
+           * @brief     reads the source, and distributes its edges
+           */
+          void readSource(const std::string &source)
+          {
+            int fd = (source == "-") ? STDIN_FILENO : open(source.c_str(), O_RDONLY);
+            if(fd < 0)
+              fail("open", source);
+
+            //Double buffered sends, a buffer is refilled once its previous send completes
+            std::vector<E> sendBuffer[2];
+            MPI_Request requests[2] = {MPI_REQUEST_NULL, MPI_REQUEST_NULL};
+            int current = 0;
+
+            std::vector<E> batch;
+            batch.reserve(2 * batchEdges);
+
+            int destination = comm.rank();
+
+            //Waits for the buffer while receiving the batches of other readers
+            auto waitForBuffer = [&](int k)
+            {
+              int done = 0;
+              while(true)
+              {
+                MPI_Test(&requests[k], &done, MPI_STATUS_IGNORE);
+                if(done) break;
+                receiveBatch(false);
+              }
+            };
+
+            auto flushBatch = [&]()
+            {
+              if(destination == comm.rank())
+                appendBatch(batch, batch.size());
+              else
+              {
+                waitForBuffer(current);
+                sendBuffer[current].swap(batch);
+                MPI_Isend(sendBuffer[current].data(), sendBuffer[current].size() * sizeof(E), MPI_BYTE, destination, BATCH_TAG, comm, &requests[current]);
+                current = 1 - current;
+              }
+
+              batch.clear();
+              destination = (destination + 1) % comm.size();
+            };
+
+            std::vector<char> chunk(CHUNK);
+
+            //Partial line carried over to the next chunk
+            std::string carry;
+
+            while(true)
+            {
+              ssize_t bytes = read(fd, chunk.data(), CHUNK);
+
+              if(bytes < 0 && errno == EINTR)
+                continue;
+
+              if(bytes < 0)
+                fail("read", source);
+
+              if(bytes == 0)
+                break;
+
+              const char *first = chunk.data();
+              const char *last = chunk.data() + bytes;
+
+              while(first != last)
+              {
+                const char *eol = std::find(first, last, '\n');
+
+                if(eol == last)
+                {
+                  carry.append(first, last);
+                  break;
+                }
+
+                const char *lineFirst = first, *lineLast = eol;
+                if(!carry.empty())
+                {
+                  carry.append(first, eol);
+                  lineFirst = carry.data();
+                  lineLast = carry.data() + carry.size();
+                }
+
+                if(lineLast != lineFirst && *(lineLast - 1) == '\r')
+                  lineLast--;
+
+                E vertex1, vertex2;
+                if(parseLine(lineFirst, lineLast, vertex1, vertex2))
+                {
+                  batch.push_back(vertex1);
+                  batch.push_back(vertex2);
+                  edgesRead++;
+                }
+
+                carry.clear();
+                first = eol + 1;
+
+                if(batch.size() == 2 * batchEdges)
+                  flushBatch();
+              }
+            }
+
+            //Last line without a newline
+            E vertex1, vertex2;
+            if(parseLine(carry.data(), carry.data() + carry.size(), vertex1, vertex2))
+            {
+              batch.push_back(vertex1);
+              batch.push_back(vertex2);
+              edgesRead++;
+            }
+
+            if(!batch.empty())
+              flushBatch();
+
+            if(fd != STDIN_FILENO)
+              close(fd);
+
+            waitForBuffer(0);
+            waitForBuffer(1);
+
+            //End markers to the other ranks
+            std::vector<MPI_Request> endRequests(comm.size(), MPI_REQUEST_NULL);
+            for(int i = 0; i < comm.size(); i++)
+              if(i != comm.rank())
+                MPI_Isend(nullptr, 0, MPI_BYTE, i, BATCH_TAG, comm, &endRequests[i]);
+
+            int done = 0;
+            while(!done)
+            {
+              MPI_Testall(comm.size(), endRequests.data(), &done, MPI_STATUSES_IGNORE);
+              if(!done)
+                receiveBatch(false);
+            }
+
+            //Our own end
+            readersDone++;
+          }
+
+        public:
+
+          /**
+           * @brief                 constructor for this class
+           * @param[in] sources     one source per reader rank, a file, a named pipe or "-" for stdin
+           * @param[in] batchEdges  edges per message
+           */
+          EdgeStreamParser(std::vector< std::pair<E, E> > &edgeList, bool addReverseEdge,
+              const std::vector<std::string> &sources, const mxx::comm &comm, std::size_t batchEdges = 1UL << 16)
+            : comm(comm.copy()),
+            addReverseEdge(addReverseEdge),
+            edgeList(edgeList),
+            sources(sources),
+            batchEdges(batchEdges)
+        {
+          assert(sources.size() > 0 && sources.size() <= (std::size_t) comm.size());
+        }
+
+          /**
+           * @brief     populates the edge list vector, returns once every source is exhausted
+           */
+          void populateEdgeList()
+          {
+            Timer timer;
+
+            readersDone = 0;
+            edgesRead = 0;
+
+            if((std::size_t) comm.rank() < sources.size())
+              readSource(sources[comm.rank()]);
+
+            while(readersDone < (int) sources.size())
+              receiveBatch(true);
+
+            auto totalEdges = mxx::reduce(edgesRead, 0, comm);
+            LOG_IF(comm.rank() == 0, INFO) << "Streamed " << totalEdges << " edges from " << sources.size() << " source(s)";
+
+            timer.end_section("Edges streamed, graph built");
+          }
+      };
+  }
+}
+
+#endif
@@ -31,6 +31,7 @@
 
 //Own includes
 #include "graphGen/common/timer.hpp"
+#include "graphGen/fileIO/aggregatedReader.hpp"
 
 //External includes
 #include "io/file_loader.hpp"
@@ -185,6 +186,59 @@ namespace conn
           timer.end_section("File IO completed, graph built");
         }
 
+        /**
+         * @brief                       populates the edge list vector, reading the file through
+         *                              a few aggregator ranks per node instead of every rank
+         * @param[in]   aggregators     count of ranks per node which read the file
+         * @param[in]   blockSize       bytes per read, each rank starts parsing once its first block is read
+         * @param[in]   directIO        read with O_DIRECT, if the file system supports it
+         * @details                     Meant for parallel file systems, where many small independent
+         *                              readers of one file perform badly. Each rank parses the records
+         *                              which begin in its byte range of the node's shared copy.
+         *                              A record running more than OVERLAP bytes past the span of
+         *                              the node aborts the job
+         */
+        void populateEdgeListAggregated(int aggregators = 1, std::size_t blockSize = 4UL << 20, bool directIO = false)
+        {
+          Timer timer;
+
+          nodeAggregatedFile file(filename, comm, aggregators, blockSize, directIO, OVERLAP);
+
+          std::size_t offset = file.begin();
+
+          //Skip the partial or full record at the beginning, the previous rank parses it
+          if(offset > 0 && offset < file.end())
+          {
+            while(offset < file.size() && file.at(offset - 1) != baseType::eol)
+              offset++;
+          }
+
+          std::string readLine;
+
+          //Records which begin in our range
+          while(offset < file.end() && offset < file.size())
+          {
+            readLine.clear();
+
+            while(offset < file.size() && file.at(offset) != baseType::eol)
+            {
+              if(file.at(offset) != baseType::cr)
+                readLine.push_back(file.at(offset));
+
+              offset++;
+            }
+
+            //Past the newline
+            offset++;
+
+            //Comment lines begin with '%'
+            if(!readLine.empty() && readLine[0] != '%')
+              parseStringForEdge(readLine);
+          }
+
+          timer.end_section("File IO completed through aggregators, graph built");
+        }
+
         /**
          * @brief             reads an edge assuming iterator points to 
          *                    beginning of a valid record
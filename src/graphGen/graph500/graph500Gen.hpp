@@ -30,6 +30,9 @@
 #include <mpi.h>
 #include <iostream>
 #include <vector>
+#include <algorithm>
+#include <climits>
+#include <cassert>
 
 //Own includes
 #include "graphGen/common/timer.hpp"
@@ -54,6 +57,8 @@ namespace conn
       private:
         static const double initiator[4];
 
+        friend class Graph500Source;
+
       public:
 
         /**
@@ -61,14 +66,17 @@ namespace conn
          * @param[out] edgeList   input vector to fill up
          * @param[in] scale       scale of the graph
          * @param[in] edgeFactor  edgeFactor of the graph
+         * @param[in] addReverseEdge  include the reverse of each edge, set to false
+         *                            for the half-edge (single direction) mode
          * @details               Each edge generated using kronecker generator is 
          *                        replicated both side ways (u--v, v--u) in 
-         *                        the edgeList
+         *                        the edgeList, unless addReverseEdge is false
          */
         void populateEdgeList( std::vector< std::pair<int64_t, int64_t> > &edgeList, 
             uint8_t scale, 
             uint8_t edgeFactor, 
-            const mxx::comm &comm)
+            const mxx::comm &comm,
+            bool addReverseEdge = true)
         {
           //seeds to use
           int64_t seeds[2] = {1,2};
@@ -95,7 +103,8 @@ namespace conn
               edgeList.emplace_back(src, dest);
 
               //Insert the reverse edge if the mode is undirected
-              edgeList.emplace_back(dest, src);
+              if(addReverseEdge)
+                edgeList.emplace_back(dest, src);
             }
           }
 
@@ -108,6 +117,91 @@ namespace conn
     };
 
     const double Graph500Gen::initiator[4] =  {.57, .19, .19, .05};
+
+    /**
+     * @class     conn::graphGen::Graph500Source
+     * @brief     Same kronecker edges as Graph500Gen, generated lazily in chunks
+     * @details   Edge generator for the ccl constructor. The edge range of this rank is generated as
+     *            several smaller ranges, each by itself. The generator decides an edge by its global
+     *            index alone, so the edges are the same. The global vertex permutation and edge
+     *            scrambling of make_graph need all the edges, and are left out, which leaves the
+     *            components the same up to the vertex ids
+     */
+    class Graph500Source
+    {
+      private:
+
+        uint_fast32_t seed[5];
+
+        int scale;
+
+        //Global count of the edges generated
+        int64_t M;
+
+        int rank, size;
+
+        //This rank's edges are the ranges of virtual ranks [rank * pieces, (rank + 1) * pieces)
+        int pieces, nextPiece = 0;
+
+        int64_t localEdges = 0;
+
+        bool addReverseEdge;
+
+      public:
+
+        using edgeType = int64_t;
+
+        /**
+         * @param[in] chunkEdges  approximate count of the edges generated at once
+         */
+        Graph500Source(uint8_t scale, uint8_t edgeFactor, const mxx::comm &comm,
+            bool addReverseEdge = true, std::size_t chunkEdges = 1UL << 20)
+          : scale(scale), rank(comm.rank()), size(comm.size()), addReverseEdge(addReverseEdge)
+        {
+          //Same seeds as Graph500Gen
+          make_mrg_seed(1, 2, seed);
+
+          M = edgeFactor * (1UL << scale);
+
+          pieces = std::max<int64_t>(1, (compute_edge_array_size(rank, size, M) + chunkEdges - 1) / chunkEdges);
+          assert((int64_t) pieces * size <= INT_MAX);
+
+          for(int i = 0; i < pieces; i++)
+            localEdges += compute_edge_array_size(rank * pieces + i, size * pieces, M);
+        }
+
+        std::size_t sizeHint() const
+        {
+          return localEdges * (addReverseEdge ? 2 : 1);
+        }
+
+        bool next(std::vector< std::pair<int64_t, int64_t> > &chunk)
+        {
+          chunk.clear();
+
+          if(nextPiece == pieces)
+            return false;
+
+          int virtualRank = rank * pieces + nextPiece++;
+
+          std::vector<int64_t> edges(2 * compute_edge_array_size(virtualRank, size * pieces, M));
+          generate_kronecker(virtualRank, size * pieces, seed, scale, M, Graph500Gen::initiator, edges.data());
+
+          for(std::size_t i = 0; i < edges.size(); i += 2)
+          {
+            //Duplicates and self loops are marked -1
+            if(edges[i] >= 0 && edges[i+1] >= 0)
+            {
+              chunk.emplace_back(edges[i], edges[i+1]);
+
+              if(addReverseEdge)
+                chunk.emplace_back(edges[i+1], edges[i]);
+            }
+          }
+
+          return true;
+        }
+    };
   }
 }
 
@@ -30,6 +30,7 @@
 #include <mpi.h>
 #include <iostream>
 #include <vector>
+#include <algorithm>
 
 //External includes
 #include "mxx/timer.hpp"
@@ -52,11 +53,14 @@ namespace conn
          * @param[in] chainLength length of the graph i.e. the count of nodes (not the edges)
          *                        For example, chain of length 100 will be like 0-1-2...100
          * @param[out] edgeList   input vector to fill up
+         * @param[in] addReverseEdge  include the reverse of each edge, set to false
+         *                            for the half-edge (single direction) mode
          */
         template <typename T>
         void populateEdgeList( std::vector< std::pair<T, T> > &edgeList, 
             uint64_t chainLength, 
-            const mxx::comm &comm = mxx::comm())
+            const mxx::comm &comm = mxx::comm(),
+            bool addReverseEdge = true)
         {
           mxx::section_timer timer;
 
@@ -74,14 +78,16 @@ namespace conn
               for(int i = beginNodeId; i < lastNodeId; i++)
               {
                 edgeList.emplace_back(i, i + 1);
-                edgeList.emplace_back(i + 1, i);
+                if(addReverseEdge)
+                  edgeList.emplace_back(i + 1, i);
               }
 
               //If not last rank, attach edges from last node of this rank to first node of next rank
               if(part.prefix_size() < chainLength)
               {
                 edgeList.emplace_back(lastNodeId, lastNodeId+1);
-                edgeList.emplace_back(lastNodeId+1, lastNodeId);
+                if(addReverseEdge)
+                  edgeList.emplace_back(lastNodeId+1, lastNodeId);
               }
             }
           }
@@ -90,6 +96,74 @@ namespace conn
         }
 
     };
+
+    /**
+     * @class     conn::graphGen::UndirectedChainSource
+     * @brief     Same chain as UndirectedChainGen, generated lazily in chunks
+     * @details   Edge generator for the ccl constructor, the edge list is never materialized
+     */
+    template <typename T>
+      class UndirectedChainSource
+      {
+        private:
+
+          //Edges (i, i+1) for i in [nextNode, endNode) remain to be generated on this rank
+          T nextNode, endNode;
+
+          bool addReverseEdge;
+
+          //Count of the edges (i, i+1) per chunk
+          std::size_t chunkEdges;
+
+        public:
+
+          using edgeType = T;
+
+          /**
+           * @param[in] chainLength     count of nodes in the chain
+           * @param[in] addReverseEdge  include the reverse of each edge, set to false
+           *                            for the half-edge (single direction) mode
+           */
+          UndirectedChainSource(uint64_t chainLength, const mxx::comm &comm = mxx::comm(),
+              bool addReverseEdge = true, std::size_t chunkEdges = 1UL << 20)
+            : addReverseEdge(addReverseEdge), chunkEdges(chunkEdges)
+          {
+            mxx::partition::block_decomposition<T> part(chainLength, comm.size(), comm.rank());
+
+            nextNode = part.excl_prefix_size();
+            endNode = part.excl_prefix_size() + part.local_size();
+
+            //Without the edge to the first node of next rank on the last rank
+            if(part.local_size() > 0 && part.prefix_size() == chainLength)
+              endNode--;
+          }
+
+          std::size_t sizeHint() const
+          {
+            return (endNode - nextNode) * (addReverseEdge ? 2 : 1);
+          }
+
+          bool next(std::vector< std::pair<T, T> > &chunk)
+          {
+            chunk.clear();
+
+            if(nextNode >= endNode)
+              return false;
+
+            T lastNode = std::min<T>(endNode, nextNode + chunkEdges);
+
+            for(T i = nextNode; i < lastNode; i++)
+            {
+              chunk.emplace_back(i, i + 1);
+              if(addReverseEdge)
+                chunk.emplace_back(i + 1, i);
+            }
+
+            nextNode = lastNode;
+
+            return true;
+          }
+      };
   }
 }
 
@@ -0,0 +1,257 @@
+/*
+ * Copyright 2016 Georgia Institute of Technology
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    boundedSort.hpp
+ * @ingroup utils
+ * @brief   Distributed sort which exchanges the data in rounds, within a memory budget
+ *
+ * Copyright (c) 2016 Georgia Institute of Technology. All Rights Reserved.
+ */
+
+#ifndef BOUNDED_SORT_HPP
+#define BOUNDED_SORT_HPP
+
+//Includes
+#include <mpi.h>
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <numeric>
+#include <iterator>
+#include <cstdint>
+#include <cassert>
+
+//External includes
+#include "mxx/comm.hpp"
+#include "mxx/collective.hpp"
+#include "mxx/reduction.hpp"
+
+namespace conn
+{
+  namespace utils
+  {
+
+    /**
+     * @brief                 local split positions of the globally sorted sequence, such that rank d
+     *                        receives targets[d] - targets[d-1] elements
+     * @param[in] targets     global positions of the p-1 boundaries between the ranks
+     * @return                p+1 local positions, elements in [splits[d], splits[d+1]) go to rank d
+     * @details               Multi-sequence selection, all boundaries are refined together. Each round
+     *                        the rank with the largest window of a boundary proposes its window median
+     *                        as the pivot, and the global count of elements below the pivot narrows the
+     *                        windows. Elements equal to the final pivot are assigned in rank order
+     */
+    template <typename Iterator, typename Compare>
+      std::vector<std::size_t> findSplits(Iterator begin, Iterator end, const std::vector<std::size_t> &targets,
+          Compare cmp, const mxx::comm &comm)
+      {
+        using T = typename std::iterator_traits<Iterator>::value_type;
+
+        std::size_t n = std::distance(begin, end);
+        std::size_t B = targets.size();
+
+        std::vector<std::size_t> lo(B, 0), hi(B, n), splits(B, 0);
+        std::vector<uint8_t> done(B, 0);
+
+        while(std::count(done.begin(), done.end(), 0) > 0)
+        {
+          //Largest window of each boundary, ties go to the lower rank
+          std::vector<uint64_t> owner(B, 0);
+          for(std::size_t b = 0; b < B; b++)
+            if(!done[b] && hi[b] > lo[b])
+              owner[b] = ((uint64_t)(hi[b] - lo[b]) << 20) | (uint64_t)(comm.size() - 1 - comm.rank());
+
+          owner = mxx::allreduce(owner, mxx::max<uint64_t>(), comm);
+
+          std::vector<T> myPivots;
+          std::vector<std::size_t> myPivotIds;
+
+          for(std::size_t b = 0; b < B; b++)
+          {
+            //Empty windows everywhere, the boundary sits right at lo
+            if(!done[b] && owner[b] == 0)
+            {
+              splits[b] = lo[b];
+              done[b] = 1;
+            }
+            else if(!done[b] && (owner[b] & ((1UL << 20) - 1)) == (uint64_t)(comm.size() - 1 - comm.rank()))
+            {
+              myPivots.push_back(*(begin + lo[b] + (hi[b] - lo[b])/2));
+              myPivotIds.push_back(b);
+            }
+          }
+
+          auto pivots = mxx::allgatherv(myPivots, comm);
+          auto pivotIds = mxx::allgatherv(myPivotIds, comm);
+
+          //Local count of elements less than, and not greater than the pivots
+          std::vector<std::size_t> counts(2*B, 0);
+          for(std::size_t i = 0; i < pivots.size(); i++)
+          {
+            std::size_t b = pivotIds[i];
+            counts[b] = std::lower_bound(begin + lo[b], begin + hi[b], pivots[i], cmp) - begin;
+            counts[B + b] = std::upper_bound(begin + lo[b], begin + hi[b], pivots[i], cmp) - begin;
+          }
+
+          auto globalCounts = mxx::allreduce(counts, std::plus<std::size_t>(), comm);
+
+          //Equal elements of the boundaries which are resolved in this round
+          std::vector<uint64_t> equal(B, 0), equalBefore(B, 0);
+          for(auto b : pivotIds)
+            if(globalCounts[b] <= targets[b] && targets[b] <= globalCounts[B + b])
+              equal[b] = counts[B + b] - counts[b];
+
+          MPI_Exscan(equal.data(), equalBefore.data(), B, MPI_UINT64_T, MPI_SUM, comm);
+          if(comm.rank() == 0)
+            std::fill(equalBefore.begin(), equalBefore.end(), 0);
+
+          for(auto b : pivotIds)
+          {
+            if(targets[b] < globalCounts[b])
+              hi[b] = counts[b];
+            else if(targets[b] > globalCounts[B + b])
+              lo[b] = counts[B + b];
+            else
+            {
+              std::size_t needed = targets[b] - globalCounts[b];
+              std::size_t mine = needed > equalBefore[b] ? std::min<std::size_t>(needed - equalBefore[b], equal[b]) : 0;
+
+              splits[b] = counts[b] + mine;
+              done[b] = 1;
+            }
+          }
+        }
+
+        splits.insert(splits.begin(), 0);
+        splits.push_back(n);
+
+        return splits;
+      }
+
+    /**
+     * @brief                 sorts the distributed range, each rank keeps its count of elements
+     * @param[in] budget      extra memory allowed in bytes, split in three among the send buffer,
+     *                        the receive buffer and the received elements waiting for a free slot
+     * @details               Same result as mxx::sort, which receives the whole data set at once and
+     *                        so needs about twice the memory of the data.
+     *                        1. Local sort, and the exact split positions through findSplits().
+     *                        2. Rounds of exchange. Each rank asks every destination for at most
+     *                           budget/(3p) elements, a destination grants no more than its free slots
+     *                           plus its budget allow. Sent elements leave free slots behind, received
+     *                           ones fill them. Rounds continue till every element reaches its rank.
+     *                        3. Local sort of the kept run and the received chunks.
+     *                        Any rank with received <= sent elements so far has room left, so every
+     *                        round makes progress
+     */
+    template <typename Iterator, typename Compare>
+      void boundedMemorySort(Iterator begin, Iterator end, Compare cmp, std::size_t budget, const mxx::comm &comm)
+      {
+        using T = typename std::iterator_traits<Iterator>::value_type;
+
+        std::sort(begin, end, cmp);
+
+        if(comm.size() == 1)
+          return;
+
+        int p = comm.size();
+        std::size_t n = std::distance(begin, end);
+
+        //Every rank keeps its size, the boundaries are the prefix sums
+        auto sizes = mxx::allgather(n, comm);
+        std::vector<std::size_t> targets(p - 1);
+        std::partial_sum(sizes.begin(), sizes.end() - 1, targets.begin());
+
+        auto splits = findSplits(begin, end, targets, cmp, comm);
+
+        //Thirds of the budget for the send buffer, the receive buffer and the pending elements
+        std::size_t limit = std::max<std::size_t>(budget / sizeof(T) / 3, p);
+        std::size_t perDestination = limit / p;
+
+        std::vector<std::size_t> cursor(splits.begin(), splits.end() - 1);
+
+        //Slots vacated by the sent elements, and received elements waiting for a slot
+        std::deque<std::pair<std::size_t, std::size_t>> freeSlots;
+        std::size_t freeSlotCount = 0;
+        std::vector<T> pending;
+
+        auto placeInFreeSlots = [&](std::vector<T> &elements) {
+          while(!elements.empty() && !freeSlots.empty())
+          {
+            auto &slots = freeSlots.front();
+            *(begin + slots.first) = elements.back();
+            elements.pop_back();
+
+            slots.first++;
+            freeSlotCount--;
+            if(slots.first == slots.second)
+              freeSlots.pop_front();
+          }
+        };
+
+        for(std::size_t round = 0; ; round++)
+        {
+          std::vector<std::size_t> requests(p, 0);
+          for(int d = 0; d < p; d++)
+            if(d != comm.rank())
+              requests[d] = std::min(splits[d+1] - cursor[d], perDestination);
+
+          std::size_t requested = std::accumulate(requests.begin(), requests.end(), (std::size_t) 0);
+          if(mxx::allreduce(requested, std::plus<std::size_t>(), comm) == 0)
+            break;
+
+          auto incoming = mxx::all2all(requests, comm);
+
+          //Grant from a rotating start rank, so no source is starved
+          std::size_t capacity = std::min(limit, freeSlotCount + limit - std::min(limit, pending.size()));
+          std::vector<std::size_t> grants(p, 0);
+          for(int i = 0; i < p; i++)
+          {
+            int s = (round + i) % p;
+            grants[s] = std::min(incoming[s], capacity);
+            capacity -= grants[s];
+          }
+
+          auto granted = mxx::all2all(grants, comm);
+
+          std::vector<T> sendBuffer;
+          for(int d = 0; d < p; d++)
+            if(granted[d] > 0)
+            {
+              sendBuffer.insert(sendBuffer.end(), begin + cursor[d], begin + cursor[d] + granted[d]);
+              freeSlots.emplace_back(cursor[d], cursor[d] + granted[d]);
+              freeSlotCount += granted[d];
+              cursor[d] += granted[d];
+            }
+
+          auto received = mxx::all2allv(sendBuffer, granted, grants, comm);
+          std::vector<T>().swap(sendBuffer);
+
+          placeInFreeSlots(pending);
+          placeInFreeSlots(received);
+          pending.insert(pending.end(), received.begin(), received.end());
+        }
+
+        //Every rank received as many elements as it sent
+        assert(pending.empty() && freeSlotCount == 0);
+
+        std::sort(begin, end, cmp);
+      }
+
+  }
+}
+
+#endif
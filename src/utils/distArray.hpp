@@ -0,0 +1,193 @@
+/*
+ * Copyright 2016 Georgia Institute of Technology
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    distArray.hpp
+ * @ingroup utils
+ * @brief   Owner routed lookups into arrays indexed by contiguous vertex ids
+ *
+ * Copyright (c) 2016 Georgia Institute of Technology. All Rights Reserved.
+ */
+
+#ifndef DIST_ARRAY_HPP
+#define DIST_ARRAY_HPP
+
+//Includes
+#include <vector>
+#include <numeric>
+#include <algorithm>
+#include <cassert>
+
+//External includes
+#include "mxx/comm.hpp"
+#include "mxx/collective.hpp"
+#include "mxx/partition.hpp"
+
+namespace conn
+{
+  namespace utils
+  {
+
+    /**
+     * @class     conn::utils::rangePartition
+     * @brief     ownership of the ids [0, n) by contiguous ranges, one per rank in rank order
+     * @details   Same interface as mxx::partition::block_decomposition, which gives the default ranges.
+     *            Ranges of other sizes come from a partitioner, see conn::graphGen::partitionVertices
+     */
+    class rangePartition
+    {
+      private:
+
+        //First id of each rank, followed by n
+        std::vector<std::size_t> starts;
+
+        int rank;
+
+      public:
+
+        /**
+         * @brief     block decomposition of [0, n)
+         */
+        rangePartition(std::size_t n, const mxx::comm &comm) : starts(comm.size() + 1), rank(comm.rank())
+        {
+          mxx::partition::block_decomposition<std::size_t> part(n, comm.size(), comm.rank());
+
+          for(int r = 0; r < comm.size(); r++)
+            starts[r] = part.excl_prefix_size(r);
+          starts[comm.size()] = n;
+        }
+
+        /**
+         * @param[in] rangeSizes    count of the ids of each rank, ranks in order
+         */
+        rangePartition(const std::vector<std::size_t> &rangeSizes, const mxx::comm &comm) : starts(comm.size() + 1, 0), rank(comm.rank())
+        {
+          assert(rangeSizes.size() == (std::size_t) comm.size());
+          std::partial_sum(rangeSizes.begin(), rangeSizes.end(), starts.begin() + 1);
+        }
+
+        std::size_t excl_prefix_size(int r) const { return starts[r]; }
+        std::size_t excl_prefix_size() const { return starts[rank]; }
+
+        std::size_t local_size(int r) const { return starts[r+1] - starts[r]; }
+        std::size_t local_size() const { return local_size(rank); }
+
+        int target_processor(std::size_t x) const
+        {
+          //Last rank whose range starts at or before x, skips the empty ranges
+          return std::upper_bound(starts.begin() + 1, starts.end() - 1, x) - starts.begin() - 1;
+        }
+    };
+
+    /**
+     * @brief             Reorders the elements by their owner rank, and returns the send counts
+     * @param[out] slot   slot[i] is the position of element i in the returned buffer
+     */
+    template <typename T, typename OwnerFunc>
+      std::vector<T> bucketByOwner(const std::vector<T> &elements, OwnerFunc owner, std::vector<std::size_t> &sendCounts,
+          std::vector<std::size_t> &slot, const mxx::comm &comm)
+      {
+        sendCounts.assign(comm.size(), 0);
+        for(auto &e : elements)
+          sendCounts[owner(e)]++;
+
+        //Exclusive prefix sum gives the start of each bucket
+        std::vector<std::size_t> offsets(comm.size(), 0);
+        std::partial_sum(sendCounts.begin(), sendCounts.end() - 1, offsets.begin() + 1);
+
+        std::vector<T> buffer(elements.size());
+        slot.resize(elements.size());
+
+        for(std::size_t i = 0; i < elements.size(); i++)
+        {
+          slot[i] = offsets[owner(elements[i])]++;
+          buffer[slot[i]] = elements[i];
+        }
+
+        return buffer;
+      }
+
+    /**
+     * @brief                   Fetches the values of a distributed array for the given keys
+     * @param[in] keys          keys to look up, each key should be in [0, n)
+     * @param[in] localValues   this rank's block of the array, [0, n) is split across the ranks as
+     *                          given by part, or block decomposed as in mxx::partition::block_decomposition
+     * @details                 Keys are routed to their owner, which replies with the values
+     *                          (two all2allv exchanges). Duplicate keys are allowed, but its
+     *                          cheaper to pass unique keys
+     * @return                  values for the keys, in the same order
+     */
+    template <typename E, typename V>
+      std::vector<V> blockLookup(const std::vector<E> &keys, const std::vector<V> &localValues, const rangePartition &part, const mxx::comm &comm)
+      {
+        std::vector<std::size_t> sendCounts, slot;
+        auto requests = bucketByOwner(keys, [&](const E &k){ return part.target_processor(k); }, sendCounts, slot, comm);
+
+        auto recvCounts = mxx::all2all(sendCounts, comm);
+        auto received = mxx::all2allv(requests, sendCounts, comm);
+        std::vector<E>().swap(requests);
+
+        //Answer the requests
+        std::size_t offset = part.excl_prefix_size();
+        std::vector<V> replies(received.size());
+        for(std::size_t i = 0; i < received.size(); i++)
+          replies[i] = localValues[received[i] - offset];
+
+        auto answers = mxx::all2allv(replies, recvCounts, comm);
+
+        std::vector<V> result(keys.size());
+        for(std::size_t i = 0; i < keys.size(); i++)
+          result[i] = answers[slot[i]];
+
+        return result;
+      }
+
+    template <typename E, typename V>
+      std::vector<V> blockLookup(const std::vector<E> &keys, const std::vector<V> &localValues, std::size_t n, const mxx::comm &comm)
+      {
+        return blockLookup(keys, localValues, rangePartition(n, comm), comm);
+      }
+
+    /**
+     * @brief                   Combines values into the entries of a distributed array
+     * @param[in] updates       <key, value> pairs, each key should be in [0, n)
+     * @param[in,out] localValues   this rank's block of the array
+     * @param[in] op            localValues[key] = op(localValues[key], value)
+     * @details                 One way exchange, updates are routed to the owner of their key. Callers
+     *                          should combine updates to the same key locally first
+     */
+    template <typename E, typename V, typename Op>
+      void blockReduce(const std::vector<std::pair<E,V>> &updates, std::vector<V> &localValues, const rangePartition &part, Op op, const mxx::comm &comm)
+      {
+        std::vector<std::size_t> sendCounts, slot;
+        auto buffer = bucketByOwner(updates, [&](const std::pair<E,V> &u){ return part.target_processor(std::get<0>(u)); }, sendCounts, slot, comm);
+
+        auto received = mxx::all2allv(buffer, sendCounts, comm);
+
+        std::size_t offset = part.excl_prefix_size();
+        for(auto &u : received)
+          localValues[std::get<0>(u) - offset] = op(localValues[std::get<0>(u) - offset], std::get<1>(u));
+      }
+
+    template <typename E, typename V, typename Op>
+      void blockReduce(const std::vector<std::pair<E,V>> &updates, std::vector<V> &localValues, std::size_t n, Op op, const mxx::comm &comm)
+      {
+        blockReduce(updates, localValues, rangePartition(n, comm), op, comm);
+      }
+  }
+}
+
+#endif
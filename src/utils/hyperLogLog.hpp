@@ -0,0 +1,127 @@
+/*
+ * Copyright 2016 Georgia Institute of Technology
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    hyperLogLog.hpp
+ * @ingroup utils
+ * @brief   Distributed HyperLogLog sketch, estimates the count of distinct values
+ *
+ * Copyright (c) 2016 Georgia Institute of Technology. All Rights Reserved.
+ */
+
+#ifndef HYPER_LOG_LOG_HPP
+#define HYPER_LOG_LOG_HPP
+
+//Includes
+#include <vector>
+#include <cmath>
+#include <cstdint>
+
+//Own includes
+#include "hash/invertible_hash.hpp"
+
+//External includes
+#include "mxx/comm.hpp"
+#include "mxx/reduction.hpp"
+
+namespace conn
+{
+  namespace utils
+  {
+
+    /**
+     * @class     conn::utils::hyperLogLog
+     * @brief     HyperLogLog sketch with 2^b registers
+     * @details   Each rank inserts its local values, merge() takes the register-wise maximum
+     *            across the ranks, after which estimate() counts the distinct values globally.
+     *            Relative standard error is 1.04 / sqrt(2^b)
+     */
+    class hyperLogLog
+    {
+      private:
+
+        //log2 of the register count
+        int b;
+
+        std::vector<uint8_t> registers;
+
+      public:
+
+        hyperLogLog(int b = 12) : b(b), registers(1 << b, 0) {}
+
+        /**
+         * @brief     adds a value to the sketch
+         */
+        void insert(uint64_t value)
+        {
+          conn::graphGen::hash_64(value);
+
+          std::size_t index = value >> (64 - b);
+
+          //Position of the first set bit among the remaining 64 - b bits
+          uint64_t rest = value << b;
+          uint8_t rank = rest == 0 ? 64 - b + 1 : __builtin_clzll(rest) + 1;
+
+          if(rank > registers[index])
+            registers[index] = rank;
+        }
+
+        /**
+         * @brief     combines the sketches of all the ranks
+         */
+        void merge(const mxx::comm &comm)
+        {
+          registers = mxx::allreduce(registers, mxx::max<uint8_t>(), comm);
+        }
+
+        /**
+         * @brief     estimated count of distinct values, with the small range (linear counting) correction
+         */
+        double estimate() const
+        {
+          double m = registers.size();
+          double alpha = 0.7213 / (1.0 + 1.079 / m);
+
+          double sum = 0.0;
+          std::size_t zeros = 0;
+
+          for(auto r : registers)
+          {
+            sum += std::ldexp(1.0, -r);
+            if(r == 0) zeros++;
+          }
+
+          double rawEstimate = alpha * m * m / sum;
+
+          if(rawEstimate <= 2.5 * m && zeros > 0)
+            return m * std::log(m / zeros);
+
+          return rawEstimate;
+        }
+
+        /**
+         * @brief     relative standard error of estimate()
+         */
+        double relativeError() const
+        {
+          return 1.04 / std::sqrt((double) registers.size());
+        }
+    };
+
+  }
+}
+
+#endif
@@ -0,0 +1,294 @@
+/*
+ * Copyright 2016 Georgia Institute of Technology
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    memPlacement.hpp
+ * @ingroup utils
+ * @brief   NUMA and huge page placement of the large per-rank arrays
+ *
+ * Copyright (c) 2016 Georgia Institute of Technology. All Rights Reserved.
+ */
+
+#ifndef MEM_PLACEMENT_HPP
+#define MEM_PLACEMENT_HPP
+
+//Includes
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <limits>
+#include <algorithm>
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+#endif
+
+//External includes
+#include "extutils/logging.hpp"
+#include "mxx/comm.hpp"
+#include "mxx/reduction.hpp"
+
+namespace conn
+{
+  namespace utils
+  {
+
+    /**
+     * @brief     memory placement policy for tuple arrays, edge lists and sort buffers
+     */
+    enum memPlacement
+    {
+      firstTouch,           //OS default, pages land on the node which touches them first (4K pages)
+      localNuma,            //prefer the NUMA node of the cpu this rank runs on
+      localNumaHugePage     //localNuma, plus transparent huge page advice (2M pages)
+    };
+
+    /**
+     * @brief     parse the placement policy from a command line string
+     *            (firsttouch, numa or numa_hugepage)
+     * @return    false if the string is none of these
+     */
+    inline bool parseMemPlacement(const std::string &s, memPlacement &placement)
+    {
+      if(s == "firsttouch")
+        placement = memPlacement::firstTouch;
+      else if(s == "numa")
+        placement = memPlacement::localNuma;
+      else if(s == "numa_hugepage")
+        placement = memPlacement::localNumaHugePage;
+      else
+        return false;
+
+      return true;
+    }
+
+    /**
+     * @brief     returns the NUMA node of the cpu this rank is currently running on
+     * @note      ranks should be pinned (e.g. mpirun --bind-to core) for this to be stable
+     */
+    inline int localNumaNode()
+    {
+#ifdef __linux__
+      unsigned cpu = 0, node = 0;
+      if(syscall(SYS_getcpu, &cpu, &node, nullptr) == 0)
+        return node;
+#endif
+      return 0;
+    }
+
+    /**
+     * @brief     node mask with only the local NUMA node set, sized to hold the node index
+     */
+    inline std::vector<unsigned long> localNodeMask()
+    {
+      const std::size_t bitsPerWord = sizeof(unsigned long) * 8;
+      std::size_t node = localNumaNode();
+
+      std::vector<unsigned long> nodeMask(node / bitsPerWord + 1, 0);
+      nodeMask[node / bitsPerWord] = 1UL << (node % bitsPerWord);
+
+      return nodeMask;
+    }
+
+    /**
+     * @brief     maxnode argument for a node mask, the kernel reads maxnode-1 bits
+     *            (same as libnuma)
+     */
+    inline unsigned long maxNode(const std::vector<unsigned long> &nodeMask)
+    {
+      return nodeMask.size() * sizeof(unsigned long) * 8 + 1;
+    }
+
+    /**
+     * @brief     count of failed madvise or mbind calls of this process since the last report
+     * @details   applyMemPlacement is not collective, so failures are counted here and
+     *            reported across the ranks by printMemPlacement
+     */
+    inline std::size_t& memPlacementFailures()
+    {
+      static std::size_t failures = 0;
+      return failures;
+    }
+
+    /**
+     * @brief     sets the default memory policy of this process
+     * @details   All future allocations of this rank, including the receive buffers
+     *            allocated internally by mxx::sort and CombBLAS, prefer the local NUMA
+     *            node. Preferred (instead of bind) policy falls back to remote memory
+     *            rather than failing when the local node is full
+     * @return    false if the policy could not be set on this rank (e.g. under seccomp),
+     *            a warning is logged once for the ranks of comm
+     */
+    inline bool setProcessMemPlacement(memPlacement placement, const mxx::comm &comm)
+    {
+      int failed = 0;
+
+#ifdef __linux__
+      if(placement != memPlacement::firstTouch)
+      {
+        std::vector<unsigned long> nodeMask = localNodeMask();
+        failed = syscall(SYS_set_mempolicy, MPOL_PREFERRED, nodeMask.data(), maxNode(nodeMask)) != 0;
+      }
+#endif
+
+      int failedRanks = mxx::allreduce(failed, std::plus<int>(), comm);
+      LOG_IF(comm.rank() == 0 && failedRanks > 0, WARNING) << "Setting the NUMA memory policy failed on " << failedRanks
+        << " ranks, their allocations fall back to first touch";
+
+      return !failed;
+    }
+
+    /**
+     * @brief                 apply the placement policy to the buffer of a vector
+     * @details               Should be called right after reserve() or reallocation, so that
+     *                        the pages are faulted in as huge pages on the local node.
+     *                        Pages which already exist are migrated (MPOL_MF_MOVE)
+     * @return                false if the advice or the binding failed, the failure is
+     *                        also counted for the next printMemPlacement report
+     */
+    template <typename T>
+      bool applyMemPlacement(std::vector<T> &v, memPlacement placement)
+      {
+#ifdef __linux__
+        if(placement == memPlacement::firstTouch || v.capacity() == 0)
+          return true;
+
+        //madvise and mbind expect page aligned ranges, so shrink the range inwards
+        const uintptr_t pageSize = sysconf(_SC_PAGESIZE);
+        uintptr_t first = reinterpret_cast<uintptr_t>(v.data());
+        uintptr_t last = first + v.capacity() * sizeof(T);
+        first = (first + pageSize - 1) & ~(pageSize - 1);
+        last = last & ~(pageSize - 1);
+
+        if(first >= last)
+          return true;
+
+        void *addr = reinterpret_cast<void *>(first);
+        std::size_t len = last - first;
+
+        bool placed = true;
+
+        if(placement == memPlacement::localNumaHugePage)
+          placed = madvise(addr, len, MADV_HUGEPAGE) == 0;
+
+        std::vector<unsigned long> nodeMask = localNodeMask();
+        if(syscall(SYS_mbind, addr, len, MPOL_PREFERRED, nodeMask.data(), maxNode(nodeMask), MPOL_MF_MOVE) != 0)
+          placed = false;
+
+        if(!placed)
+          memPlacementFailures()++;
+
+        return placed;
+#else
+        return true;
+#endif
+      }
+
+    /**
+     * @brief     size of anonymous memory backed by transparent huge pages in this process (KB)
+     */
+    inline std::size_t anonHugePagesKB()
+    {
+      std::size_t total = 0;
+
+#ifdef __linux__
+      std::ifstream smaps("/proc/self/smaps_rollup");
+      std::string key;
+
+      while(smaps >> key)
+      {
+        if(key == "AnonHugePages:")
+        {
+          smaps >> total;
+          break;
+        }
+        smaps.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+      }
+#endif
+
+      return total;
+    }
+
+    /**
+     * @details   Memory telemetry, prints the min-mean-max percentage of the sampled
+     *            pages of the vector which reside on the rank's local NUMA node, and
+     *            the min-mean-max memory backed by huge pages across ranks
+     */
+    template <typename T>
+      void printMemPlacement(std::vector<T> &v, const std::string &name, const mxx::comm &comm)
+      {
+        //Percentage of sampled pages found on the local node
+        double localPct = 100.0;
+
+#ifdef __linux__
+        const uintptr_t pageSize = sysconf(_SC_PAGESIZE);
+        const std::size_t maxSamples = 1024;
+
+        uintptr_t first = reinterpret_cast<uintptr_t>(v.data());
+        std::size_t nPages = (v.size() * sizeof(T)) / pageSize;
+
+        if(nPages > 0)
+        {
+          std::size_t stride = std::max(nPages / maxSamples, (std::size_t) 1);
+          std::size_t sampled = 0, local = 0;
+          int myNode = localNumaNode();
+
+          for(std::size_t i = 0; i < nPages; i += stride)
+          {
+            int node = -1;
+            void *addr = reinterpret_cast<void *>(first + i * pageSize);
+            if(syscall(SYS_get_mempolicy, &node, nullptr, 0, addr, MPOL_F_NODE | MPOL_F_ADDR) == 0)
+            {
+              sampled++;
+              if(node == myNode) local++;
+            }
+          }
+
+          if(sampled > 0)
+            localPct = 100.0 * local / sampled;
+        }
+#endif
+
+        double hugeMB = anonHugePagesKB() / 1024.0;
+
+        double minPct  = mxx::reduce(localPct, 0, mxx::min<double>(), comm);
+        double meanPct = mxx::reduce(localPct, 0, std::plus<double>(), comm) / comm.size();
+        double maxPct  = mxx::reduce(localPct, 0, mxx::max<double>(), comm);
+
+        double minHuge  = mxx::reduce(hugeMB, 0, mxx::min<double>(), comm);
+        double meanHuge = mxx::reduce(hugeMB, 0, std::plus<double>(), comm) / comm.size();
+        double maxHuge  = mxx::reduce(hugeMB, 0, mxx::max<double>(), comm);
+
+        //Report the failed placements once, then start counting afresh
+        std::size_t failures = mxx::allreduce(memPlacementFailures(), std::plus<std::size_t>(), comm);
+        memPlacementFailures() = 0;
+
+        LOG_IF(comm.rank() == 0 && failures > 0, WARNING) << "Memory placement advice failed " << failures
+          << " times across the ranks, pages are placed by first touch";
+
+        auto sep = ",";
+        LOG_IF(comm.rank() == 0, INFO) << "Memory placement of " << name << ", local NUMA pages % min-mean-max : "
+          << minPct << sep << meanPct << sep << maxPct
+          << ", huge page backed MB min-mean-max : " << minHuge << sep << meanHuge << sep << maxHuge;
+      }
+  }
+}
+
+#endif
@@ -0,0 +1,165 @@
+/*
+ * Copyright 2016 Georgia Institute of Technology
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    packedId.hpp
+ * @ingroup utils
+ * @brief   Vertex ids stored in 5 or 6 bytes, for graphs beyond 32-bit ids
+ *
+ * Copyright (c) 2016 Georgia Institute of Technology. All Rights Reserved.
+ */
+
+#ifndef PACKED_ID_HPP
+#define PACKED_ID_HPP
+
+//Includes
+#include <vector>
+#include <array>
+#include <limits>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+//External includes
+#include "mxx/comm.hpp"
+#include "mxx/reduction.hpp"
+#include "mxx/datatype.hpp"
+
+namespace conn
+{
+  namespace utils
+  {
+
+    /**
+     * @class     conn::utils::packedId
+     * @brief     unsigned integer of BYTES bytes with byte alignment, so that pairs and tuples of 
+     *            ids are stored without padding (12 bytes per edge and 18 bytes per ccl tuple with 6 bytes)
+     * @details   Converts implicitly to and from uint64_t, all the arithmetic and comparisons happen
+     *            on the unpacked value. Assumes a little endian machine
+     */
+    template <int BYTES>
+      class packedId
+      {
+        static_assert(BYTES > 0 && BYTES < 8, "packed ids should be narrower than 64 bits");
+
+        public:
+
+        std::array<uint8_t, BYTES> bytes;
+
+        packedId() = default;
+
+        packedId(uint64_t value)
+        {
+          std::memcpy(bytes.data(), &value, BYTES);
+        }
+
+        operator uint64_t() const
+        {
+          uint64_t value = 0;
+          std::memcpy(&value, bytes.data(), BYTES);
+          return value;
+        }
+
+        packedId& operator++()
+        {
+          *this = static_cast<uint64_t>(*this) + 1;
+          return *this;
+        }
+
+        packedId& operator+=(uint64_t value)
+        {
+          *this = static_cast<uint64_t>(*this) + value;
+          return *this;
+        }
+      };
+
+    //40 bit ids, up to ~10^12 vertices
+    using uint40_t = packedId<5>;
+
+    //48 bit ids
+    using uint48_t = packedId<6>;
+
+    /**
+     * @brief                   copies an edge list into packed ids and releases the input
+     * @param[in,out] edgeList  edges with ids in [0, 2^(8*BYTES) - 2), the top two values are reserved
+     *                          by ccl as its MAX_PID and MAX_PID2 markers. Emptied on success
+     * @param[out] packedList   the same edges, in the same order
+     * @return                  false if an id of this rank's edges does not fit, nothing is copied then
+     *                          and edgeList is left as is
+     * @note                    run reduceVertexIds() before, hashed ids do not fit
+     */
+    template <typename E, int BYTES>
+      bool packEdgeList(std::vector<std::pair<E,E>> &edgeList, std::vector<std::pair<packedId<BYTES>, packedId<BYTES>>> &packedList)
+      {
+        const uint64_t limit = std::numeric_limits<packedId<BYTES>>::max() - 1;
+
+        packedList.clear();
+
+        bool fits = std::all_of(edgeList.begin(), edgeList.end(), [&](const std::pair<E,E> &e){
+            return static_cast<uint64_t>(e.first) < limit && static_cast<uint64_t>(e.second) < limit;
+            });
+
+        if(!fits)
+          return false;
+
+        packedList.reserve(edgeList.size());
+
+        for(auto &e : edgeList)
+          packedList.emplace_back(static_cast<uint64_t>(e.first), static_cast<uint64_t>(e.second));
+
+        std::vector<std::pair<E,E>>().swap(edgeList);
+
+        return true;
+      }
+
+    /**
+     * @brief                   bytes needed per vertex id for the given count of contiguous ids,
+     *                          among 5, 6 and 8
+     */
+    inline int packedIdBytes(std::size_t nVertices)
+    {
+      //Two top values stay reserved
+      if(nVertices + 2 <= (1UL << 40))
+        return 5;
+      else if(nVertices + 2 <= (1UL << 48))
+        return 6;
+      else
+        return 8;
+    }
+  }
+}
+
+namespace std
+{
+  template <int BYTES>
+    class numeric_limits<conn::utils::packedId<BYTES>>
+    {
+      public:
+        static constexpr bool is_specialized = true;
+        static constexpr bool is_signed = false;
+        static constexpr bool is_integer = true;
+        static constexpr int digits = 8 * BYTES;
+
+        static conn::utils::packedId<BYTES> min() { return conn::utils::packedId<BYTES>(0); }
+        static conn::utils::packedId<BYTES> max() { return conn::utils::packedId<BYTES>((1UL << (8 * BYTES)) - 1); }
+    };
+}
+
+//MPI datatypes of the packed ids, for sorting and communicating tuples of them
+MXX_CUSTOM_STRUCT(conn::utils::uint40_t, bytes);
+MXX_CUSTOM_STRUCT(conn::utils::uint48_t, bytes);
+
+#endif
@@ -26,15 +26,27 @@
 //Includes
 #include <mpi.h>
 #include <iostream>
+#include <fstream>
+#include <sstream>
 
 //Own includes
 #include "graphGen/fileIO/graphReader.hpp"
+#include "graphGen/fileIO/edgeStream.hpp"
 #include "graphGen/deBruijn/deBruijnGraphGen.hpp"
 #include "graphGen/graph500/graph500Gen.hpp"
+#include "graphGen/undirectedChain/undirectedChainGen.hpp"
 #include "graphGen/common/reduceIds.hpp"
+#include "graphGen/common/reorderIds.hpp"
+#include "graphGen/common/partitionGraph.hpp"
 #include "coloring/labelProp.hpp"
+#include "coloring/fastSV.hpp"
+#include "coloring/rmaUnionFind.hpp"
+#include "coloring/batchConnectivity.hpp"
 #include "bfs/bfsRunner.hpp"
 #include "dynamic/degreeDistInfo.hpp"
+#include "dynamic/memoryPlanner.hpp"
+#include "utils/memPlacement.hpp"
+#include "utils/packedId.hpp"
 
 //External includes
 #include "extutils/logging.hpp"
@@ -47,6 +59,120 @@ INITIALIZE_EASYLOGGINGPP
 using namespace std;
 using namespace CommandLineProcessing;
 
+/**
+ * @brief   coloring settings, applied to every ccl instance of this benchmark
+ */
+struct coloringOptions
+{
+  //Extra memory for the coloring sorts, 0 for the regular sort
+  std::size_t sortBudget = 0;
+
+  bool compressStable = false;
+
+  //Iterations before coloring stops with bounds on the count, 0 to run till convergence
+  std::size_t iterationLimit = 0;
+
+  bool progressEstimates = false;
+
+  //Passed to the ccl constructor, 64 bit ids only
+  conn::coloring::labelPriority priority = conn::coloring::labelPriority::vertexId;
+};
+
+/**
+ * @brief                   applies the options to a ccl instance, runs it and counts the components
+ * @param[out] approxRange  width of the component count range, 0 unless an iteration limit is set
+ * @return                  count of components, its lower bound with an iteration limit
+ */
+template <typename CclType>
+std::size_t runColoring(CclType &cclInstance, const coloringOptions &options, std::size_t &approxRange)
+{
+  cclInstance.setSortMemoryBudget(options.sortBudget);
+  cclInstance.setStableCompression(options.compressStable);
+  cclInstance.setIterationLimit(options.iterationLimit);
+  cclInstance.setProgressEstimates(options.progressEstimates);
+
+  cclInstance.compute();
+
+  approxRange = 0;
+
+  if(options.iterationLimit == 0)
+    return cclInstance.computeComponentCount();
+
+  std::size_t lowerBound, upperBound;
+  double largestFraction;
+
+  cclInstance.estimateComponentStatistics(lowerBound, upperBound, largestFraction);
+
+  approxRange = upperBound - lowerBound;
+  return lowerBound;
+}
+
+/**
+ * @brief                   runs coloring with the vertex ids packed in BYTES bytes
+ * @param[out] approxRange  width of the component count range, 0 unless an iteration limit is set
+ * @return                  count of components found by coloring
+ */
+template <int BYTES, uint8_t OPTIMIZATION, uint8_t RELAXATION, typename E>
+std::size_t runPackedIdsCcl(std::vector<std::pair<E,E>> &edgeList, const mxx::comm &comm,
+    conn::utils::memPlacement placement, conn::graphGen::edgeStorage storage, const coloringOptions &options, std::size_t &approxRange)
+{
+  std::size_t countComponents = 0;
+  approxRange = 0;
+
+  std::vector< std::pair<conn::utils::packedId<BYTES>, conn::utils::packedId<BYTES>> > packedEdgeList;
+  bool fits = conn::utils::packEdgeList(edgeList, packedEdgeList);
+  if(mxx::allreduce((int) !fits, mxx::max<int>(), comm))
+  {
+    if (!comm.rank()) std::cout << "Vertex ids do not fit in " << BYTES << " bytes" << std::endl;
+    exit(1);
+  }
+
+  LOG_IF(!comm.rank(), INFO) << "Vertex ids packed in " << BYTES << " bytes";
+
+  comm.with_subset(packedEdgeList.size() > 0, [&](const mxx::comm& comm){
+      conn::coloring::ccl<conn::utils::packedId<BYTES>, conn::coloring::lever::ON, OPTIMIZATION, RELAXATION> cclInstance(packedEdgeList, comm, placement, storage, options.priority);
+
+      //We no longer need to store the edgeList
+      packedEdgeList.clear();
+
+      countComponents = runColoring(cclInstance, options, approxRange);
+      });
+
+  return countComponents;
+}
+
+/**
+ * @brief                   runs coloring with the given optimization level and relaxation lever
+ * @param[in] idBytes       5 or 6 to pack the vertex ids in as many bytes, the ids must be contiguous then
+ * @param[out] approxRange  width of the component count range, 0 unless an iteration limit is set
+ * @return                  count of components found by coloring
+ */
+template <uint8_t OPTIMIZATION, uint8_t RELAXATION, typename E>
+std::size_t runCcl(std::vector<std::pair<E,E>> &edgeList, const mxx::comm &comm,
+    conn::utils::memPlacement placement, conn::graphGen::edgeStorage storage, const coloringOptions &options,
+    int idBytes, std::size_t &approxRange)
+{
+  if(idBytes == 5)
+    return runPackedIdsCcl<5, OPTIMIZATION, RELAXATION>(edgeList, comm, placement, storage, options, approxRange);
+
+  if(idBytes == 6)
+    return runPackedIdsCcl<6, OPTIMIZATION, RELAXATION>(edgeList, comm, placement, storage, options, approxRange);
+
+  std::size_t countComponents = 0;
+  approxRange = 0;
+
+  comm.with_subset(edgeList.size() > 0, [&](const mxx::comm& comm){
+      conn::coloring::ccl<E, conn::coloring::lever::ON, OPTIMIZATION, RELAXATION> cclInstance(edgeList, comm, placement, storage, options.priority);
+
+      //We no longer need to store the edgeList
+      edgeList.clear();
+
+      countComponents = runColoring(cclInstance, options, approxRange);
+      });
+
+  return countComponents;
+}
+
 int main(int argc, char** argv)
 {
   // Initialize the MPI library:
@@ -70,9 +196,28 @@ int main(int argc, char** argv)
   cmd.setIntroductoryDescription("Benchmark for computing connectivity of large undirected graphs");
   cmd.setHelpOption("h", "help", "Print this help page");
 
-  cmd.defineOption("input", "dbg or kronecker or generic", ArgvParser::OptionRequiresValue | ArgvParser::OptionRequired);
-  cmd.defineOption("file", "input file (if input = dbg or generic)", ArgvParser::OptionRequiresValue);
+  cmd.defineOption("input", "dbg or kronecker or generic or batch or stream or chain", ArgvParser::OptionRequiresValue | ArgvParser::OptionRequired);
+  cmd.defineOption("file", "input file (if input = dbg or generic), or a file listing one generic input file per line (if input = batch), or comma separated pipes or - for stdin, one per reader rank (if input = stream)", ArgvParser::OptionRequiresValue);
   cmd.defineOption("scale", "scale of the graph (if input = kronecker)", ArgvParser::OptionRequiresValue);
+  cmd.defineOption("aggregators", "count of ranks per node which read the input file (if input = generic), for parallel file systems", ArgvParser::OptionRequiresValue);
+  cmd.defineOption("directio", "read the input file bypassing the page cache, with --aggregators", ArgvParser::NoOptionAttribute);
+  cmd.defineOption("halfedges", "store each undirected edge once instead of both ways, halves the memory of the input stage", ArgvParser::NoOptionAttribute);
+  cmd.defineOption("reorder", "reorder the vertex ids by label propagation clusters, improves locality of BFS and coloring", ArgvParser::NoOptionAttribute);
+  cmd.defineOption("partition", "assign vertices to ranks by label propagation partitioning, reduces the edges between ranks (if engine = sv or rma)", ArgvParser::NoOptionAttribute);
+  cmd.defineOption("engine", "ccl or sv or lacc or rma, connectivity engine run after BFS, default is ccl", ArgvParser::OptionRequiresValue);
+  cmd.defineOption("relax", "propagate labels to a local fixpoint on each rank during every coloring iteration", ArgvParser::NoOptionAttribute);
+  cmd.defineOption("boundary", "keep only the boundary nodes of the partitions in the coloring sorts", ArgvParser::NoOptionAttribute);
+  cmd.defineOption("priority", "vertexid or random, order in which the coloring labels compete, random avoids long propagation along sequentially numbered paths, default is vertexid", ArgvParser::OptionRequiresValue);
+  cmd.defineOption("maxbfs", "upper bound on the count of BFS runs before coloring, default is 8", ArgvParser::OptionRequiresValue);
+  cmd.defineOption("packedids", "store the vertex ids in 5 or 6 bytes during coloring, as the vertex count allows", ArgvParser::NoOptionAttribute);
+  cmd.defineOption("sortbudget", "extra memory per rank in MB for each coloring sort, exchanges the tuples in rounds within it", ArgvParser::OptionRequiresValue);
+  cmd.defineOption("compress", "keep the stable coloring tuples compressed till the end", ArgvParser::NoOptionAttribute);
+  cmd.defineOption("memlimit", "memory per rank in MB, with the ccl or lacc engine, skips BFS and picks the packedids, sortbudget and compress settings to fit it", ArgvParser::OptionRequiresValue);
+  cmd.defineOption("approx", "stop coloring after these many iterations and report bounds on the component count", ArgvParser::OptionRequiresValue);
+  cmd.defineOption("progress", "log the estimated component statistics after each coloring iteration", ArgvParser::NoOptionAttribute);
+  cmd.defineOption("implicit", "coloring generates the edges in chunks, without storing the edge list (if input = kronecker or chain, which needs it), skips BFS", ArgvParser::NoOptionAttribute);
+  cmd.defineOption("chainLength", "length of undirected chain graph (if input = chain)", ArgvParser::OptionRequiresValue);
+  cmd.defineOption("memplacement", "firsttouch or numa or numa_hugepage, placement of the large arrays, default is firsttouch", ArgvParser::OptionRequiresValue);
 
   int result = cmd.parse(argc, argv);
 
@@ -83,6 +228,31 @@ int main(int argc, char** argv)
     exit(1);
   }
 
+  //Memory placement policy, applied before any large allocation
+  conn::utils::memPlacement placement = conn::utils::memPlacement::firstTouch;
+  if(cmd.foundOption("memplacement") && !conn::utils::parseMemPlacement(cmd.optionValue("memplacement"), placement))
+  {
+    std::cout << "Wrong memplacement value given" << std::endl;
+    exit(1);
+  }
+
+  conn::utils::setProcessMemPlacement(placement, comm);
+
+  //Label priority of coloring
+  conn::coloring::labelPriority priority = conn::coloring::labelPriority::vertexId;
+  if(cmd.foundOption("priority") && !conn::coloring::parseLabelPriority(cmd.optionValue("priority"), priority))
+  {
+    std::cout << "Wrong priority value given" << std::endl;
+    exit(1);
+  }
+
+  //Half-edge mode, reverse edges are implied instead of stored
+  conn::graphGen::edgeStorage storage = conn::graphGen::edgeStorage::bothWays;
+  if(cmd.foundOption("halfedges"))
+    storage = conn::graphGen::edgeStorage::halfEdges;
+
+  bool addReverse = (storage == conn::graphGen::edgeStorage::bothWays);
+
   /**
    * GENERATE GRAPH
    */
@@ -99,6 +269,192 @@ int main(int argc, char** argv)
   mxx::section_timer timer(std::cerr, comm);
 #endif
 
+  //Batch of graphs, components of each graph are computed in a single coloring run
+  if(cmd.optionValue("input") == "batch")
+  {
+    if(!cmd.foundOption("file"))
+    {
+      std::cout << "Required option missing: '--file'\n";
+      exit(1);
+    }
+
+    //Batch runs the plain ccl over the packed graph ids, other stages and settings do not apply
+    if(cmd.foundOption("engine") && cmd.optionValue("engine") != "ccl")
+    {
+      if (!comm.rank()) std::cout << "batch input needs the ccl engine" << std::endl;
+      exit(1);
+    }
+
+    for(std::string option : {"packedids", "memlimit", "relax", "boundary", "priority", "approx", "progress", "sortbudget", "compress",
+        "reorder", "partition", "maxbfs", "implicit", "aggregators", "directio"})
+      if(cmd.foundOption(option))
+      {
+        if (!comm.rank()) std::cout << option << " option is not supported with batch input" << std::endl;
+        exit(1);
+      }
+
+    std::vector<std::string> fileNames;
+    {
+      std::ifstream listFile(cmd.optionValue("file"));
+      std::string line;
+      while(std::getline(listFile, line))
+        if(!line.empty())
+          fileNames.push_back(line);
+    }
+
+    LOG_IF(!comm.rank(), INFO) << "Batch of " << fileNames.size() << " input files";
+
+    //Edges tagged with the index of their file
+    std::vector< std::tuple<vertexIdType, vertexIdType, vertexIdType> > batchEdgeList;
+
+    for(std::size_t i = 0; i < fileNames.size(); i++)
+    {
+      conn::graphGen::GraphFileParser<char *, vertexIdType> g(edgeList, addReverse, fileNames[i], comm);
+      g.populateEdgeList();
+
+      for(auto &e : edgeList)
+        batchEdgeList.emplace_back(i, std::get<0>(e), std::get<1>(e));
+
+      edgeList.clear();
+    }
+
+#ifdef BENCHMARK_CONN
+    timer.end_section("Graph construction completed");
+#endif
+
+    comm.barrier();
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::size_t> countComponents(fileNames.size(), 0);
+
+    comm.with_subset(batchEdgeList.size() > 0, [&](const mxx::comm& comm){
+        conn::coloring::batchCcl<vertexIdType> batchInstance(batchEdgeList, fileNames.size(), comm, storage);
+
+        //We no longer need to store the edgeList
+        batchEdgeList.clear();
+
+        batchInstance.compute();
+
+        countComponents = batchInstance.computeComponentCounts();
+        });
+
+    countComponents = mxx::allreduce(countComponents, mxx::max<std::size_t>(), comm);
+
+    for(std::size_t i = 0; i < countComponents.size(); i++)
+      LOG_IF(!comm.rank(), INFO) << "Count of components in " << fileNames[i] << " -> " << countComponents[i];
+
+    comm.barrier();
+    auto end = std::chrono::steady_clock::now();
+    auto elapsed_time  = std::chrono::duration<double, std::milli>(end - start).count(); 
+
+    LOG_IF(!comm.rank(), INFO) << "Time excluding graph construction (ms) -> " << elapsed_time;
+
+    MPI_Finalize();
+    return(0);
+  }
+
+  //Coloring pulls the edges from the generator, the graph construction is part of the timing
+  if(cmd.foundOption("implicit") || cmd.optionValue("input") == "chain")
+  {
+    bool kronecker = cmd.optionValue("input") == "kronecker";
+
+    //Chain graphs are only generated during coloring
+    if(!cmd.foundOption("implicit"))
+    {
+      if (!comm.rank()) std::cout << "chain input needs the implicit option" << std::endl;
+      exit(1);
+    }
+
+    if(!kronecker && cmd.optionValue("input") != "chain")
+    {
+      if (!comm.rank()) std::cout << "implicit option needs input = kronecker or chain" << std::endl;
+      exit(1);
+    }
+
+    if(kronecker ? !cmd.foundOption("scale") : !cmd.foundOption("chainLength"))
+    {
+      std::cout << "Required option missing: " << (kronecker ? "'--scale'" : "'--chainLength'") << "\n";
+      exit(1);
+    }
+
+    //The edge list is never stored, so only the ccl engine over unmodified ids runs
+    if((cmd.foundOption("engine") && cmd.optionValue("engine") != "ccl") || cmd.foundOption("memlimit") || cmd.foundOption("packedids")
+        || cmd.foundOption("reorder") || cmd.foundOption("partition"))
+    {
+      if (!comm.rank()) std::cout << "implicit option needs the ccl engine, without memlimit, packedids, reorder or partition" << std::endl;
+      exit(1);
+    }
+
+    coloringOptions options;
+    options.sortBudget = cmd.foundOption("sortbudget") ? std::stoul(cmd.optionValue("sortbudget")) << 20 : 0;
+    options.compressStable = cmd.foundOption("compress");
+    options.iterationLimit = cmd.foundOption("approx") ? std::stoul(cmd.optionValue("approx")) : 0;
+    options.progressEstimates = cmd.foundOption("progress");
+    options.priority = priority;
+
+    if(kronecker)
+      LOG_IF(!comm.rank(), INFO) << "Scale -> " << cmd.optionValue("scale") << ", edges generated during coloring";
+    else
+      LOG_IF(!comm.rank(), INFO) << "Chain length -> " << cmd.optionValue("chainLength") << ", edges generated during coloring";
+
+    comm.barrier();
+    auto start = std::chrono::steady_clock::now();
+
+    std::size_t countComponents, approxComponentsRange;
+
+    //Ids are permuted chunk by chunk, same as the edge list
+    auto colorSource = [&](auto &source)
+    {
+      conn::graphGen::permutedEdgeSource<typename std::remove_reference<decltype(source)>::type> permutedSource(source);
+
+      if(cmd.foundOption("relax"))
+      {
+        conn::coloring::ccl<vertexIdType, conn::coloring::lever::ON, conn::coloring::opt_level::loadbalanced, conn::coloring::lever::ON> cclInstance(permutedSource, comm, placement, storage, options.priority);
+        countComponents = runColoring(cclInstance, options, approxComponentsRange);
+      }
+      else if(cmd.foundOption("boundary"))
+      {
+        conn::coloring::ccl<vertexIdType, conn::coloring::lever::ON, conn::coloring::opt_level::boundary_active_set> cclInstance(permutedSource, comm, placement, storage, options.priority);
+        countComponents = runColoring(cclInstance, options, approxComponentsRange);
+      }
+      else
+      {
+        conn::coloring::ccl<vertexIdType, conn::coloring::lever::ON> cclInstance(permutedSource, comm, placement, storage, options.priority);
+        countComponents = runColoring(cclInstance, options, approxComponentsRange);
+      }
+    };
+
+    if(kronecker)
+    {
+      conn::graphGen::Graph500Source source(std::stoi(cmd.optionValue("scale")), 16, comm, addReverse);
+      colorSource(source);
+    }
+    else
+    {
+      conn::graphGen::UndirectedChainSource<vertexIdType> source(std::stoul(cmd.optionValue("chainLength")), comm, addReverse);
+      colorSource(source);
+    }
+
+    countComponents = mxx::allreduce(countComponents, mxx::max<std::size_t>());
+
+    if(cmd.foundOption("approx"))
+    {
+      approxComponentsRange = mxx::allreduce(approxComponentsRange, mxx::max<std::size_t>());
+      LOG_IF(!comm.rank(), INFO) << "Count of components -> between " << countComponents << " and " << countComponents + approxComponentsRange;
+    }
+    else
+      LOG_IF(!comm.rank(), INFO) << "Count of components -> " << countComponents;
+
+    comm.barrier();
+    auto end = std::chrono::steady_clock::now();
+    auto elapsed_time  = std::chrono::duration<double, std::milli>(end - start).count(); 
+
+    LOG_IF(!comm.rank(), INFO) << "Time including graph generation (ms) -> " << elapsed_time;
+
+    MPI_Finalize();
+    return(0);
+  }
+
   //Construct graph based on the given input mode
   if(cmd.optionValue("input") == "generic")
   {
@@ -114,12 +470,43 @@ int main(int argc, char** argv)
 
     LOG_IF(!comm.rank(), INFO) << "Input file -> " << fileName;
 
-    //Add reverse of the edges
-    bool addReverse = true;
-
     //Object of the graph generator class
     conn::graphGen::GraphFileParser<char *, vertexIdType> g(edgeList, addReverse, fileName, comm);
 
+    //Populate the edgeList
+    if(cmd.foundOption("aggregators"))
+      g.populateEdgeListAggregated(std::stoi(cmd.optionValue("aggregators")), 4UL << 20, cmd.foundOption("directio"));
+    else
+      g.populateEdgeList();
+  }
+  else if(cmd.optionValue("input") == "stream")
+  {
+    if(!cmd.foundOption("file"))
+    {
+      std::cout << "Required option missing: '--file'\n";
+      exit(1);
+    }
+
+    //Sources read by the ranks 0, 1, ...
+    std::vector<std::string> sources;
+    {
+      std::stringstream sourceList(cmd.optionValue("file"));
+      std::string source;
+      while(std::getline(sourceList, source, ','))
+        if(!source.empty())
+          sources.push_back(source);
+    }
+
+    if(sources.empty() || sources.size() > (std::size_t) comm.size())
+    {
+      if (!comm.rank()) std::cout << "Give between 1 and " << comm.size() << " sources, one per reader rank" << std::endl;
+      exit(1);
+    }
+
+    LOG_IF(!comm.rank(), INFO) << "Streaming edges from " << cmd.optionValue("file");
+
+    conn::graphGen::EdgeStreamParser<vertexIdType> g(edgeList, addReverse, sources, comm);
+
     //Populate the edgeList
     g.populateEdgeList();
   }
@@ -141,7 +528,7 @@ int main(int argc, char** argv)
     conn::graphGen::deBruijnGraph g;
 
     //Populate the edgeList
-    g.populateEdgeList(edgeList, fileName, comm); 
+    g.populateEdgeList(edgeList, fileName, comm, addReverse); 
   }
   else if(cmd.optionValue("input") == "kronecker")
   {
@@ -162,7 +549,7 @@ int main(int argc, char** argv)
     conn::graphGen::Graph500Gen g;
 
     //Populate the edgeList
-    g.populateEdgeList(edgeList, scale, edgefactor, comm); 
+    g.populateEdgeList(edgeList, scale, edgefactor, comm, addReverse); 
   }
   else
   {
@@ -174,6 +561,12 @@ int main(int argc, char** argv)
   timer.end_section("Graph construction completed");
 #endif
 
+  if(placement != conn::utils::memPlacement::firstTouch)
+  {
+    conn::utils::applyMemPlacement(edgeList, placement);
+    conn::utils::printMemPlacement(edgeList, "edge list", comm);
+  }
+
   /**
    * COMPUTE CONNECTIVITY
    */
@@ -191,7 +584,71 @@ int main(int argc, char** argv)
   timer.end_section("Vertex Ids permuted");
 #endif
 
-  bool runBFS = conn::dynamic::runBFSDecision(edgeList, comm);
+  //Remove self loops and duplicate edges, this also does the sort needed by runBFSDecision
+  conn::graphGen::removeDuplicateEdges(edgeList, comm, storage);
+
+#ifdef BENCHMARK_CONN
+  timer.end_section("Duplicate edges removed");
+#endif
+
+  bool runBFS = conn::dynamic::runBFSDecision(edgeList, comm, storage);
+  std::size_t maxBFSIterations = cmd.foundOption("maxbfs") ? std::stoul(cmd.optionValue("maxbfs")) : 8;
+  bool runSV = cmd.foundOption("engine") && cmd.optionValue("engine") == "sv";
+  bool runLACC = cmd.foundOption("engine") && cmd.optionValue("engine") == "lacc";
+  bool runRMA = cmd.foundOption("engine") && cmd.optionValue("engine") == "rma";
+
+  //Bounds and estimates on the count, and label priorities, are only available from coloring
+  if((runSV || runLACC || runRMA) && (cmd.foundOption("approx") || cmd.foundOption("progress") || cmd.foundOption("priority")))
+  {
+    if (!comm.rank()) std::cout << "approx, progress and priority options need the ccl engine" << std::endl;
+    exit(1);
+  }
+
+  //Only the sv and rma engines own the partitioned id ranges, others would discard them
+  if(cmd.foundOption("partition") && !(runSV || runRMA))
+  {
+    if (!comm.rank()) std::cout << "partition option needs the sv or rma engine" << std::endl;
+    exit(1);
+  }
+
+  bool packedIds = cmd.foundOption("packedids");
+  bool compressStable = cmd.foundOption("compress");
+
+  //Extra memory for the coloring sorts, 0 for the regular sort
+  std::size_t sortBudget = cmd.foundOption("sortbudget") ? std::stoul(cmd.optionValue("sortbudget")) << 20 : 0;
+
+  //Fit the stages in the memory budget, the explicit options are kept
+  if(cmd.foundOption("memlimit"))
+  {
+    //Planner models the coloring and the BFS matrix only
+    if(runSV || runRMA)
+    {
+      if (!comm.rank()) std::cout << "memlimit option needs the ccl or lacc engine" << std::endl;
+      exit(1);
+    }
+
+    std::size_t memoryBudget = std::stoul(cmd.optionValue("memlimit")) << 20;
+
+    auto plan = conn::dynamic::planExecution(edgeList, runBFS, memoryBudget, comm, storage, runLACC);
+    conn::dynamic::printExecutionPlan(plan, memoryBudget, comm);
+
+    //Coloring would not finish, so stop before any stage runs
+    if(!plan.feasible)
+    {
+      if (!comm.rank()) std::cout << "Estimated peak of " << (plan.peakBytes >> 20) << " MB per rank does not fit in memlimit, the coloring tuples alone exceed it" << std::endl;
+      exit(1);
+    }
+
+    runBFS = plan.runBFS;
+    packedIds = packedIds || plan.packedIds;
+    compressStable = compressStable || plan.compressStable;
+
+    if(sortBudget == 0)
+      sortBudget = plan.sortBudget;
+  }
+
+  //Stages which need contiguous vertex ids
+  bool compactIds = runBFS || runSV || runLACC || runRMA || cmd.foundOption("reorder") || cmd.foundOption("partition") || packedIds;
 
 #ifdef BENCHMARK_CONN
     timer.end_section("Graph fit stastistics calculated");
@@ -199,9 +656,9 @@ int main(int argc, char** argv)
 
   //Call the graph reducer function
   //Index the vertex ids from 0 to |V|-1
-  if(runBFS) 
+  if(compactIds) 
   {
-    conn::graphGen::reduceVertexIds(edgeList, nVertices, comm);
+    conn::graphGen::reduceVertexIds(edgeList, nVertices, comm, storage);
     LOG_IF(!comm.rank(), INFO) << "Ids compacted for BFS run";
 
 #ifdef BENCHMARK_CONN
@@ -209,63 +666,180 @@ int main(int argc, char** argv)
 #endif
   }
 
+  //Place the clusters of the graph in contiguous id ranges
+  if(cmd.foundOption("reorder"))
+  {
+    conn::graphGen::reorderVertexIds(edgeList, nVertices, comm, storage);
+
+#ifdef BENCHMARK_CONN
+    timer.end_section("Vertex Ids reordered for locality");
+#endif
+  }
+
+  //Count of the ids owned by each rank, empty for block decomposed ownership
+  std::vector<std::size_t> vertexRanges;
+
+  //Assign the vertices to ranks to reduce the cut edges
+  if(cmd.foundOption("partition"))
+  {
+    vertexRanges = conn::graphGen::partitionVertices(edgeList, nVertices, comm, storage);
+
+#ifdef BENCHMARK_CONN
+    timer.end_section("Graph partitioned");
+#endif
+  }
+
 
   //Count of edges in the graph
   std::size_t nEdges = conn::graphGen::globalSizeOfVector(edgeList, comm);
 
-  if(runBFS) 
-    LOG_IF(!comm.rank(), INFO) << "Graph size : vertices -> " << nVertices << ", edges -> " << nEdges/2  << " (x2)";
+  //Undirected edge count
+  std::string edgeCountNote = addReverse ? " (x2)" : " (half-edges)";
+  if(addReverse) nEdges = nEdges/2;
 
-  if(!runBFS)
-    LOG_IF(!comm.rank(), INFO) << "Graph size : edges -> " << nEdges/2 << " (x2)";
+  if(compactIds) 
+    LOG_IF(!comm.rank(), INFO) << "Graph size : vertices -> " << nVertices << ", edges -> " << nEdges << edgeCountNote;
+
+  if(!compactIds)
+    LOG_IF(!comm.rank(), INFO) << "Graph size : edges -> " << nEdges << edgeCountNote;
 
   //For saving the size of component discovered using BFS
   std::vector<std::size_t> componentCountsResult;
 
   std::size_t noBFSIterationsExecuted = 0;
 
-  if(runBFS)
+  //Components labeled on the BFS matrix itself
+  std::size_t laccComponents = 0;
+
+  //BFS stage, run with either local index type of the matrix
+  auto runBFSStage = [&](auto &bfsInstance)
   {
-    conn::bfs::bfsSupport<vertexIdType> bfsInstance(edgeList, nVertices, comm);
+    if(runBFS)
+    {
+      std::size_t residualVertices, totalDegreeSum, maxResidualDegree;
+      bfsInstance.residualDegreeSummary(residualVertices, totalDegreeSum, maxResidualDegree);
+
+      //Run BFS from the hub of the remaining graph, as long as the decision favors it
+      //The matrix is built once, later runs only skip the visited vertices
+      bool runNextBFS = true;
+      while(runNextBFS && noBFSIterationsExecuted < maxBFSIterations)
+      {
+        std::size_t executed = bfsInstance.runBFSIterations(1, componentCountsResult, true); 
+        noBFSIterationsExecuted += executed;
+
+        if(executed == 0)
+          break;
+
+        LOG_IF(!comm.rank(), INFO) << "Number of vertices visited by BFS iteration #" << noBFSIterationsExecuted << " -> " << componentCountsResult.back();
 
-    //Run BFS once
-    noBFSIterationsExecuted = bfsInstance.runBFSIterations(1, componentCountsResult); 
+        std::size_t residualDegreeSum;
+        bfsInstance.residualDegreeSummary(residualVertices, residualDegreeSum, maxResidualDegree);
+        runNextBFS = conn::dynamic::runNextBFSDecision(residualVertices, residualDegreeSum, maxResidualDegree, totalDegreeSum, comm);
+      }
 
 #ifdef BENCHMARK_CONN
-    timer.end_section("BFS iterations executed");
+      timer.end_section("BFS iterations executed");
 #endif
+    }
 
-    LOG_IF(!comm.rank(), INFO) << "Number of vertices visited by 1st BFS iteration -> " << componentCountsResult[0];
+    if(runLACC)
+    {
+      //Label the remaining components on the same matrix
+      laccComponents = bfsInstance.runLinearAlgebraicCC();
+      edgeList.clear();
 
-    //Get the remaining edgeList
-    bfsInstance.filterEdgeList();
+#ifdef BENCHMARK_CONN
+      timer.end_section("Linear algebraic CC completed");
+#endif
+    }
+    else
+    {
+      //Get the remaining edgeList
+      bfsInstance.filterEdgeList();
 
 #ifdef BENCHMARK_CONN
-    timer.end_section("Remaining graph filtered out");
+      timer.end_section("Remaining graph filtered out");
 #endif
+    }
+  };
+
+  if(runBFS || runLACC)
+  {
+    //32-bit indices within the local matrix blocks, if they fit
+    if(conn::bfs::bfsSupport<vertexIdType, int32_t>::localIdsFit(nVertices, comm))
+    {
+      conn::bfs::bfsSupport<vertexIdType, int32_t> bfsInstance(edgeList, nVertices, comm, storage);
+      runBFSStage(bfsInstance);
+    }
+    else
+    {
+      conn::bfs::bfsSupport<vertexIdType> bfsInstance(edgeList, nVertices, comm, storage);
+      runBFSStage(bfsInstance);
+    }
   }
 
-  std::size_t countComponents = noBFSIterationsExecuted;
+  std::size_t countComponents = noBFSIterationsExecuted + laccComponents;
+
+  //Width of the component count range, with an iteration limit on coloring
+  std::size_t approxComponentsRange = 0;
+
+  coloringOptions options;
+  options.sortBudget = sortBudget;
+  options.compressStable = compressStable;
+  options.iterationLimit = cmd.foundOption("approx") ? std::stoul(cmd.optionValue("approx")) : 0;
+  options.progressEstimates = cmd.foundOption("progress");
+  options.priority = priority;
 
   LOG_IF(!comm.rank(), INFO) << noBFSIterationsExecuted << " BFS iterations executed";
 
-  comm.with_subset(edgeList.size() > 0, [&](const mxx::comm& comm){
-      conn::coloring::ccl<vertexIdType, conn::coloring::lever::ON> cclInstance(edgeList, comm);
+  if(runSV)
+  {
+    conn::coloring::fastSV<vertexIdType> svInstance(edgeList, nVertices, comm, storage, vertexRanges);
 
-      //We no longer need to store the edgeList
-      edgeList.clear();
+    //We no longer need to store the edgeList
+    edgeList.clear();
 
-      cclInstance.compute();
+    svInstance.compute();
 
-      countComponents += cclInstance.computeComponentCount();
-      });
+    countComponents += svInstance.computeComponentCount();
+  }
+  else if(runRMA)
+  {
+    conn::coloring::rmaUnionFind<vertexIdType> rmaInstance(edgeList, nVertices, comm, storage, vertexRanges);
+
+    //We no longer need to store the edgeList
+    edgeList.clear();
+
+    rmaInstance.compute();
+
+    countComponents += rmaInstance.computeComponentCount();
+  }
+  else if(!runLACC)
+  {
+    //Packed ids, as the option or the plan chose, apply to every coloring variant
+    int idBytes = packedIds ? conn::utils::packedIdBytes(nVertices) : sizeof(vertexIdType);
+
+    if(cmd.foundOption("relax"))
+      countComponents += runCcl<conn::coloring::opt_level::loadbalanced, conn::coloring::lever::ON>(edgeList, comm, placement, storage, options, idBytes, approxComponentsRange);
+    else if(cmd.foundOption("boundary"))
+      countComponents += runCcl<conn::coloring::opt_level::boundary_active_set, conn::coloring::lever::OFF>(edgeList, comm, placement, storage, options, idBytes, approxComponentsRange);
+    else
+      countComponents += runCcl<conn::coloring::opt_level::loadbalanced, conn::coloring::lever::OFF>(edgeList, comm, placement, storage, options, idBytes, approxComponentsRange);
+  }
 
 #ifdef BENCHMARK_CONN
     timer.end_section("Coloring completed");
 #endif
 
   countComponents = mxx::allreduce(countComponents, mxx::max<std::size_t>());
-  LOG_IF(!comm.rank(), INFO) << "Count of components -> " << countComponents;
+
+  if(cmd.foundOption("approx"))
+  {
+    approxComponentsRange = mxx::allreduce(approxComponentsRange, mxx::max<std::size_t>());
+    LOG_IF(!comm.rank(), INFO) << "Count of components -> between " << countComponents << " and " << countComponents + approxComponentsRange;
+  }
+  else
+    LOG_IF(!comm.rank(), INFO) << "Count of components -> " << countComponents;
 
   comm.barrier();
   auto end = std::chrono::steady_clock::now();
@@ -198,3 +198,243 @@ TEST(bfsRunCheck, multipleUndirectedChainsMultipleRunsOneAtTime) {
     ASSERT_EQ(leftEdgesCount, 0);
   }
 }
+
+/**
+ * @brief     Each rank initializes a chain graph of length 50, 
+ *            we run BFS once and label the rest using linear 
+ *            algebraic connected components
+ */
+TEST(bfsRunCheck, linearAlgebraicCC) {
+
+  mxx::comm comm = mxx::comm();
+
+  //Type to use for vertices
+  using vertexIdType = int64_t;
+
+  //Distributed edge list
+  std::vector< std::pair<vertexIdType, vertexIdType> > edgeList;
+
+  std::size_t offset = 50*comm.rank();
+
+  //Each rank builds undirected chain of length 50
+  //[0---49], [50---99] and so on
+  for(int i = 0; i < 49; i ++)
+  {
+    edgeList.emplace_back(i    +offset, i+1  +offset);
+    edgeList.emplace_back(i+1  +offset, i    +offset);
+  }
+
+  //Count of vertices
+  std::size_t nVertices = 50*comm.size();
+
+  {
+    conn::bfs::bfsSupport<vertexIdType> bfsInstance(edgeList, nVertices, comm);
+    std::vector<std::size_t> componentCountsResult;
+    bfsInstance.runBFSIterations(1, componentCountsResult); 
+
+    //Components left after the BFS run
+    auto remainingComponents = bfsInstance.runLinearAlgebraicCC();
+
+    ASSERT_EQ(remainingComponents, comm.size() - 1);
+  }
+}
+
+/**
+ * @brief     Each rank initializes a chain graph of length 50 with each
+ *            edge stored once, in alternating directions. The matrix is
+ *            symmetrized, so the degrees and BFS runs should match the
+ *            chains stored both ways
+ */
+TEST(bfsRunCheck, halfEdgesSymmetrized) {
+
+  mxx::comm comm = mxx::comm();
+
+  //Type to use for vertices
+  using vertexIdType = int64_t;
+
+  //Distributed edge list
+  std::vector< std::pair<vertexIdType, vertexIdType> > edgeList;
+
+  std::size_t offset = 50*comm.rank();
+
+  for(int i = 0; i < 49; i ++)
+  {
+    if(i % 2)
+      edgeList.emplace_back(i    +offset, i+1  +offset);
+    else
+      edgeList.emplace_back(i+1  +offset, i    +offset);
+  }
+
+  //Count of vertices
+  std::size_t nVertices = 50*comm.size();
+
+  {
+    conn::bfs::bfsSupport<vertexIdType> bfsInstance(edgeList, nVertices, comm, conn::graphGen::edgeStorage::halfEdges);
+
+    std::size_t residualVertices, residualDegreeSum, maxResidualDegree;
+    bfsInstance.residualDegreeSummary(residualVertices, residualDegreeSum, maxResidualDegree);
+
+    ASSERT_EQ(residualVertices, 50*comm.size());
+    ASSERT_EQ(residualDegreeSum, 98*comm.size());
+    ASSERT_EQ(maxResidualDegree, 2);
+
+    std::vector<std::size_t> componentCountsResult;
+    bfsInstance.runBFSIterations(comm.size(), componentCountsResult); 
+
+    ASSERT_EQ(componentCountsResult.size(), comm.size());
+    for(auto count : componentCountsResult)
+      ASSERT_EQ(count, 50);
+
+    bfsInstance.filterEdgeList();
+    ASSERT_EQ(conn::graphGen::globalSizeOfVector(edgeList, comm), 0);
+  }
+}
+
+/**
+ * @brief     Each rank initializes a chain graph of length 50 with each
+ *            edge stored once, linear algebraic connected components
+ *            should label all the chains on the symmetrized matrix, and
+ *            the chains left after one BFS run on a second instance
+ */
+TEST(bfsRunCheck, linearAlgebraicCCHalfEdges) {
+
+  mxx::comm comm = mxx::comm();
+
+  //Type to use for vertices
+  using vertexIdType = int64_t;
+
+  //Distributed edge list
+  std::vector< std::pair<vertexIdType, vertexIdType> > edgeList;
+
+  std::size_t offset = 50*comm.rank();
+
+  for(int i = 0; i < 49; i ++)
+  {
+    if(i % 2)
+      edgeList.emplace_back(i    +offset, i+1  +offset);
+    else
+      edgeList.emplace_back(i+1  +offset, i    +offset);
+  }
+
+  //Count of vertices
+  std::size_t nVertices = 50*comm.size();
+
+  {
+    conn::bfs::bfsSupport<vertexIdType> bfsInstance(edgeList, nVertices, comm, conn::graphGen::edgeStorage::halfEdges);
+
+    ASSERT_EQ(bfsInstance.runLinearAlgebraicCC(), comm.size());
+  }
+
+  {
+    conn::bfs::bfsSupport<vertexIdType> bfsInstance(edgeList, nVertices, comm, conn::graphGen::edgeStorage::halfEdges);
+    std::vector<std::size_t> componentCountsResult;
+    bfsInstance.runBFSIterations(1, componentCountsResult); 
+
+    ASSERT_EQ(bfsInstance.runLinearAlgebraicCC(), comm.size() - 1);
+
+    bfsInstance.filterEdgeList();
+    ASSERT_EQ(conn::graphGen::globalSizeOfVector(edgeList, comm), 0);
+  }
+}
+
+/**
+ * @brief     Each rank initializes a chain graph of length 50, rank 0
+ *            also adds a star with 20 leaves. BFS started from the 
+ *            maximum degree vertex should visit the star first, and 
+ *            leave the chains in the residual degree summary
+ */
+TEST(bfsRunCheck, maxDegreeSourceResidualSummary) {
+
+  mxx::comm comm = mxx::comm();
+
+  //Type to use for vertices
+  using vertexIdType = int64_t;
+
+  //Distributed edge list
+  std::vector< std::pair<vertexIdType, vertexIdType> > edgeList;
+
+  std::size_t offset = 50*comm.rank();
+
+  //Each rank builds undirected chain of length 50
+  //[0---49], [50---99] and so on
+  for(int i = 0; i < 49; i ++)
+  {
+    edgeList.emplace_back(i    +offset, i+1  +offset);
+    edgeList.emplace_back(i+1  +offset, i    +offset);
+  }
+
+  //Star centered at 50*p, leaves 50*p+1 ... 50*p+20
+  std::size_t center = 50*comm.size();
+
+  if(comm.rank() == 0)
+    for(int i = 1; i <= 20; i++)
+    {
+      edgeList.emplace_back(center, center + i);
+      edgeList.emplace_back(center + i, center);
+    }
+
+  //Count of vertices
+  std::size_t nVertices = 50*comm.size() + 21;
+
+  {
+    conn::bfs::bfsSupport<vertexIdType> bfsInstance(edgeList, nVertices, comm);
+    std::vector<std::size_t> componentCountsResult;
+    bfsInstance.runBFSIterations(1, componentCountsResult, true); 
+
+    ASSERT_EQ(componentCountsResult[0], 21);
+
+    std::size_t residualVertices, residualDegreeSum, maxResidualDegree;
+    bfsInstance.residualDegreeSummary(residualVertices, residualDegreeSum, maxResidualDegree);
+
+    ASSERT_EQ(residualVertices, 50*comm.size());
+    ASSERT_EQ(residualDegreeSum, 98*comm.size());
+    ASSERT_EQ(maxResidualDegree, 2);
+  }
+}
+
+/**
+ * @brief     Each rank initializes a chain graph of length 50, and we
+ *            run BFS p times with 32-bit local indices in the matrix
+ */
+TEST(bfsRunCheck, localIndices32Bit) {
+
+  mxx::comm comm = mxx::comm();
+
+  //Type to use for vertices
+  using vertexIdType = int64_t;
+
+  //Distributed edge list
+  std::vector< std::pair<vertexIdType, vertexIdType> > edgeList;
+
+  std::size_t offset = 50*comm.rank();
+
+  //Each rank builds undirected chain of length 50
+  //[0---49], [50---99] and so on
+  for(int i = 0; i < 49; i ++)
+  {
+    edgeList.emplace_back(i    +offset, i+1  +offset);
+    edgeList.emplace_back(i+1  +offset, i    +offset);
+  }
+
+  //Count of vertices
+  std::size_t nVertices = 50*comm.size();
+
+  ASSERT_TRUE((conn::bfs::bfsSupport<vertexIdType, int32_t>::localIdsFit(nVertices, comm)));
+
+  {
+    conn::bfs::bfsSupport<vertexIdType, int32_t> bfsInstance(edgeList, nVertices, comm);
+    std::vector<std::size_t> componentCountsResult;
+    bfsInstance.runBFSIterations(comm.size(), componentCountsResult); 
+
+    std::vector<std::size_t> componentCountsExpected(comm.size(), 50);
+
+    ASSERT_EQ(componentCountsResult.size(), comm.size());
+    ASSERT_TRUE(std::equal(componentCountsResult.begin(), componentCountsResult.end(), componentCountsExpected.begin()));
+
+    //Remove the edges associated with the visited components
+    bfsInstance.filterEdgeList();
+
+    auto leftEdgesCount = conn::graphGen::globalSizeOfVector(edgeList, comm);
+    ASSERT_EQ(leftEdgesCount, 0);
+  }
+}
@@ -27,6 +27,15 @@
 
 //Own includes
 #include "coloring/labelProp.hpp"
+#include "coloring/fastSV.hpp"
+#include "coloring/rmaUnionFind.hpp"
+#include "coloring/batchConnectivity.hpp"
+#include "coloring/embedding.hpp"
+#include "graphGen/common/reduceIds.hpp"
+#include "graphGen/common/partitionGraph.hpp"
+#include "graphGen/undirectedChain/undirectedChainGen.hpp"
+#include "utils/packedId.hpp"
+#include "dynamic/memoryPlanner.hpp"
 
 //External includes
 #include "mxx/comm.hpp"
@@ -201,3 +210,809 @@ TEST(connColoring, mediumUndirected) {
   ASSERT_EQ(3, component_count);
 }
 
+
+/**
+ * @brief       coloring of undirected graph stored as half-edges
+ * @details     builds the medium test graph with three components, but 
+ *              each edge is inserted only once, in alternating directions.
+ *              Test if program returns 3 as the component count
+ */
+TEST(connColoring, mediumUndirectedHalfEdges) {
+
+  mxx::comm c = mxx::comm();
+
+  //Declare a edgeList vector to save edges
+  std::vector< std::pair<uint64_t, uint64_t> > edgeList;
+
+  //Start adding the edges
+  if (c.rank() == 0) {
+
+    //First component (2,3,4,11)
+    edgeList.emplace_back(2,11);
+    edgeList.emplace_back(3,2);
+    edgeList.emplace_back(2,4);
+    edgeList.emplace_back(4,3);
+
+    //Second component (5,6,8,10)
+    edgeList.emplace_back(5,6);
+    edgeList.emplace_back(8,5);
+    edgeList.emplace_back(6,10);
+    edgeList.emplace_back(8,6);
+
+    //Third component (chain 50-51-...1000)
+    for(int i = 50; i < 1000 ; i++)
+    {
+      if(i % 2)
+        edgeList.emplace_back(i, i+1);
+      else
+        edgeList.emplace_back(i+1, i);
+    }
+  }
+
+  std::random_shuffle(edgeList.begin(), edgeList.end());
+  auto edgeListCopy = edgeList;
+
+  conn::coloring::ccl<> cclInstance(edgeList, c, conn::utils::memPlacement::firstTouch, conn::graphGen::edgeStorage::halfEdges);
+  cclInstance.compute();
+  auto component_count = cclInstance.computeComponentCount();
+  ASSERT_EQ(3, component_count);
+
+  //Edges of the chain, the self tuples are not counted
+  auto largest = cclInstance.computeLargestComponentSize();
+  ASSERT_EQ(950, largest);
+
+  //Same from the unsorted tuples, without the sizes recorded as the partitions stabilize
+  conn::coloring::ccl<uint64_t, conn::coloring::lever::ON, conn::coloring::opt_level::naive> naiveInstance(edgeListCopy, c, conn::utils::memPlacement::firstTouch, conn::graphGen::edgeStorage::halfEdges);
+  naiveInstance.compute();
+  ASSERT_EQ(950, naiveInstance.computeLargestComponentSize());
+}
+
+/**
+ * @brief       connected components using the FastSV engine
+ * @details     same graph as mediumUndirectedHalfEdges, ids are made contiguous
+ *              first, test if program returns 3 as the component count
+ */
+TEST(connColoring, fastSVHalfEdges) {
+
+  mxx::comm c = mxx::comm();
+
+  //Declare a edgeList vector to save edges
+  std::vector< std::pair<uint64_t, uint64_t> > edgeList;
+
+  //Start adding the edges
+  if (c.rank() == 0) {
+
+    //First component (2,3,4,11)
+    edgeList.emplace_back(2,11);
+    edgeList.emplace_back(3,2);
+    edgeList.emplace_back(2,4);
+    edgeList.emplace_back(4,3);
+
+    //Second component (5,6,8,10)
+    edgeList.emplace_back(5,6);
+    edgeList.emplace_back(8,5);
+    edgeList.emplace_back(6,10);
+    edgeList.emplace_back(8,6);
+
+    //Third component (chain 50-51-...1000)
+    for(int i = 50; i < 1000 ; i++)
+    {
+      if(i % 2)
+        edgeList.emplace_back(i, i+1);
+      else
+        edgeList.emplace_back(i+1, i);
+    }
+  }
+
+  std::random_shuffle(edgeList.begin(), edgeList.end());
+
+  std::size_t nVertices;
+  conn::graphGen::reduceVertexIds(edgeList, nVertices, c, conn::graphGen::edgeStorage::halfEdges);
+
+  conn::coloring::fastSV<uint64_t> svInstance(edgeList, nVertices, c, conn::graphGen::edgeStorage::halfEdges);
+  svInstance.compute();
+  auto component_count = svInstance.computeComponentCount();
+  ASSERT_EQ(3, component_count);
+}
+
+/**
+ * @brief       connected components using the one sided union-find engine
+ * @details     three chains of length 100 on each rank, interleaved ids,
+ *              test if program returns 3p as the component count
+ */
+TEST(connColoring, rmaUnionFind) {
+
+  mxx::comm c = mxx::comm();
+
+  //Declare a edgeList vector to save edges
+  std::vector< std::pair<int64_t, int64_t> > edgeList;
+
+  int64_t offset = 300 * c.rank();
+
+  //Chain j has the vertices offset + j, offset + j + 3, ...
+  for(int j = 0; j < 3; j++)
+    for(int i = 0; i < 99; i++)
+    {
+      edgeList.emplace_back(offset + j + 3*i, offset + j + 3*(i+1));
+      edgeList.emplace_back(offset + j + 3*(i+1), offset + j + 3*i);
+    }
+
+  std::random_shuffle(edgeList.begin(), edgeList.end());
+
+  std::size_t nVertices = 300 * c.size();
+
+  conn::coloring::rmaUnionFind<int64_t> rmaInstance(edgeList, nVertices, c);
+  rmaInstance.compute();
+  auto component_count = rmaInstance.computeComponentCount();
+  ASSERT_EQ(3 * c.size(), component_count);
+}
+
+/**
+ * @brief       FastSV and one sided union-find over partitioned vertex ranges
+ * @details     same chains as rmaUnionFind, the ids are relabeled by partitionVertices()
+ *              and its ranges are passed to the engines as their ownership map,
+ *              test if both return 3p as the component count
+ */
+TEST(connColoring, partitionedVertexRanges) {
+
+  mxx::comm c = mxx::comm();
+
+  //Declare a edgeList vector to save edges
+  std::vector< std::pair<int64_t, int64_t> > edgeList;
+
+  int64_t offset = 300 * c.rank();
+
+  //Chain j has the vertices offset + j, offset + j + 3, ...
+  for(int j = 0; j < 3; j++)
+    for(int i = 0; i < 99; i++)
+    {
+      edgeList.emplace_back(offset + j + 3*i, offset + j + 3*(i+1));
+      edgeList.emplace_back(offset + j + 3*(i+1), offset + j + 3*i);
+    }
+
+  std::size_t nVertices = 300 * c.size();
+
+  auto vertexRanges = conn::graphGen::partitionVertices(edgeList, nVertices, c, conn::graphGen::edgeStorage::bothWays, 0.05);
+
+  {
+    auto edgeListCopy = edgeList;
+    conn::coloring::fastSV<int64_t> svInstance(edgeListCopy, nVertices, c, conn::graphGen::edgeStorage::bothWays, vertexRanges);
+    svInstance.compute();
+    ASSERT_EQ(3 * c.size(), svInstance.computeComponentCount());
+  }
+
+  conn::coloring::rmaUnionFind<int64_t> rmaInstance(edgeList, nVertices, c, conn::graphGen::edgeStorage::bothWays, vertexRanges);
+  rmaInstance.compute();
+  ASSERT_EQ(3 * c.size(), rmaInstance.computeComponentCount());
+}
+
+/**
+ * @brief       coloring of a sequentially numbered chain with random label priorities
+ * @details     builds an undirected chain 1-2-...10000,
+ *              test if program returns 1 as the component count, and if every vertex
+ *              gets the same label which is one of the vertex ids.
+ *              A second chain includes the id which hashes to the reserved label,
+ *              test if the coloring still returns 1 and labels all 101 vertices
+ */
+TEST(connColoring, randomLabelPriority) {
+
+  mxx::comm c = mxx::comm();
+
+  //Declare a edgeList vector to save edges
+  std::vector< std::pair<uint64_t, uint64_t> > edgeList;
+
+  //Start adding the edges
+  if (c.rank() == 0) {
+
+    for(int i = 1; i < 10000 ; i++)
+    {
+      edgeList.emplace_back(i, i+1);
+      edgeList.emplace_back(i+1, i);
+    }
+  }
+
+  conn::coloring::ccl<> cclInstance(edgeList, c, conn::utils::memPlacement::firstTouch, 
+      conn::graphGen::edgeStorage::bothWays, conn::coloring::labelPriority::randomHash);
+  cclInstance.compute();
+  auto component_count = cclInstance.computeComponentCount();
+  ASSERT_EQ(1, component_count);
+
+  std::vector< std::pair<uint64_t, uint64_t> > labels;
+  cclInstance.getVertexLabels(labels);
+
+  auto labelCount = mxx::allreduce(labels.size(), std::plus<std::size_t>(), c);
+  ASSERT_EQ(10000, labelCount);
+
+  //Labels are translated back to vertex ids
+  uint64_t minLabel = std::numeric_limits<uint64_t>::max(), maxLabel = 0;
+  for(auto &l : labels)
+  {
+    ASSERT_TRUE(l.first >= 1 && l.first <= 10000);
+    ASSERT_TRUE(l.second >= 1 && l.second <= 10000);
+    minLabel = std::min(minLabel, l.second);
+    maxLabel = std::max(maxLabel, l.second);
+  }
+
+  ASSERT_EQ(mxx::allreduce(minLabel, mxx::min<uint64_t>(), c), mxx::allreduce(maxLabel, mxx::max<uint64_t>(), c));
+
+  //Vertex which hashes to the reserved MAX_PID
+  uint64_t reservedId = std::numeric_limits<uint64_t>::max();
+  conn::graphGen::hash_64i(reservedId);
+
+  if (c.rank() == 0) {
+    edgeList.clear();
+
+    for(int i = 1; i < 100 ; i++)
+    {
+      edgeList.emplace_back(i, i+1);
+      edgeList.emplace_back(i+1, i);
+    }
+
+    edgeList.emplace_back(100, reservedId);
+    edgeList.emplace_back(reservedId, 100);
+  }
+
+  conn::coloring::ccl<> reservedInstance(edgeList, c, conn::utils::memPlacement::firstTouch, 
+      conn::graphGen::edgeStorage::bothWays, conn::coloring::labelPriority::randomHash);
+  reservedInstance.compute();
+  ASSERT_EQ(1, reservedInstance.computeComponentCount());
+
+  //Reserved vertex keeps its tuples
+  reservedInstance.getVertexLabels(labels);
+  ASSERT_EQ(101, mxx::allreduce(labels.size(), std::plus<std::size_t>(), c));
+}
+
+/**
+ * @brief       coloring with local relaxation in each iteration
+ * @details     same graph as mediumUndirected, 
+ *              test if program returns 3 as the component count
+ */
+TEST(connColoring, mediumUndirectedLocalRelaxation) {
+
+  mxx::comm c = mxx::comm();
+
+  //Declare a edgeList vector to save edges
+  std::vector< std::pair<uint64_t, uint64_t> > edgeList;
+
+  //Start adding the edges
+  if (c.rank() == 0) {
+
+    //First component (2,3,4,11)
+    edgeList.emplace_back(2,11);
+    edgeList.emplace_back(11,2);
+    edgeList.emplace_back(2,3);
+    edgeList.emplace_back(3,2);
+    edgeList.emplace_back(2,4);
+    edgeList.emplace_back(4,2);
+    edgeList.emplace_back(3,4);
+    edgeList.emplace_back(4,3);
+
+    //Second component (5,6,8,10)
+    edgeList.emplace_back(5,6);
+    edgeList.emplace_back(6,5);
+    edgeList.emplace_back(5,8);
+    edgeList.emplace_back(8,5);
+    edgeList.emplace_back(6,10);
+    edgeList.emplace_back(10,6);
+    edgeList.emplace_back(6,8);
+    edgeList.emplace_back(8,6);
+
+    //Third component (chain 50-51-...1000)
+    for(int i = 50; i < 1000 ; i++)
+    {
+      edgeList.emplace_back(i, i+1);
+      edgeList.emplace_back(i+1, i);
+    }
+  }
+
+  std::random_shuffle(edgeList.begin(), edgeList.end());
+  conn::coloring::ccl<uint64_t, conn::coloring::lever::ON, conn::coloring::opt_level::loadbalanced, conn::coloring::lever::ON> cclInstance(edgeList, c);
+  cclInstance.compute();
+  auto component_count = cclInstance.computeComponentCount();
+  ASSERT_EQ(3, component_count);
+}
+
+/**
+ * @brief       coloring with only the boundary nodes kept in the sorts
+ * @details     builds a clique of 50 nodes (mostly interior tuples) and a chain,
+ *              test if program returns 2 as the component count and
+ *              the clique's edge count as the largest component size 
+ */
+TEST(connColoring, boundaryActiveSet) {
+
+  mxx::comm c = mxx::comm();
+
+  //Declare a edgeList vector to save edges
+  std::vector< std::pair<uint64_t, uint64_t> > edgeList;
+
+  //Start adding the edges
+  if (c.rank() == 0) {
+
+    //First component (clique 0-49)
+    for(int i = 0; i < 50 ; i++)
+      for(int j = 0; j < 50 ; j++)
+        if(i != j)
+          edgeList.emplace_back(i, j);
+
+    //Second component (chain 100-101-...1000)
+    for(int i = 100; i < 1000 ; i++)
+    {
+      edgeList.emplace_back(i, i+1);
+      edgeList.emplace_back(i+1, i);
+    }
+  }
+
+  std::random_shuffle(edgeList.begin(), edgeList.end());
+  conn::coloring::ccl<uint64_t, conn::coloring::lever::ON, conn::coloring::opt_level::boundary_active_set> cclInstance(edgeList, c);
+  cclInstance.compute();
+  auto component_count = cclInstance.computeComponentCount();
+  ASSERT_EQ(2, component_count);
+
+  auto largest = cclInstance.computeLargestComponentSize();
+  ASSERT_EQ(50*49/2, largest);
+}
+
+/**
+ * @brief       component count bounds before and after convergence
+ * @details     A clique and a long chain, the chain does not converge in one iteration.
+ *              Test if the bounds contain the count 2, and if the lower bound is exact on convergence
+ */
+TEST(connColoring, anytimeEstimates) {
+
+  mxx::comm c = mxx::comm();
+
+  //Declare a edgeList vector to save edges
+  std::vector< std::pair<uint64_t, uint64_t> > edgeList;
+
+  //Start adding the edges
+  if (c.rank() == 0) {
+
+    //First component (clique 0-49)
+    for(int i = 0; i < 50 ; i++)
+      for(int j = 0; j < 50 ; j++)
+        if(i != j)
+          edgeList.emplace_back(i, j);
+
+    //Second component (chain 100-101-...1000)
+    for(int i = 100; i < 1000 ; i++)
+    {
+      edgeList.emplace_back(i, i+1);
+      edgeList.emplace_back(i+1, i);
+    }
+  }
+
+  std::random_shuffle(edgeList.begin(), edgeList.end());
+  auto edgeListCopy = edgeList;
+
+  std::size_t lowerBound, upperBound;
+  double largestFraction;
+
+  conn::coloring::ccl<uint64_t> partialInstance(edgeList, c);
+  partialInstance.setIterationLimit(1);
+  partialInstance.compute();
+  partialInstance.estimateComponentStatistics(lowerBound, upperBound, largestFraction);
+  ASSERT_LE(lowerBound, 2);
+  ASSERT_GE(upperBound, 2);
+  ASSERT_GT(largestFraction, 0.0);
+
+  conn::coloring::ccl<uint64_t> cclInstance(edgeListCopy, c);
+  cclInstance.compute();
+  cclInstance.estimateComponentStatistics(lowerBound, upperBound, largestFraction);
+  ASSERT_EQ(2, lowerBound);
+  ASSERT_GE(upperBound, 2);
+  ASSERT_LE(largestFraction, 1.0);
+}
+
+/**
+ * @brief       coloring with 48-bit packed vertex ids
+ * @details     A clique and a chain, with ids close to the 40-bit limit.
+ *              Test if program returns 2 as the component count and the clique as the largest
+ */
+TEST(connColoring, packedIds) {
+
+  mxx::comm c = mxx::comm();
+
+  const uint64_t offset = 1UL << 39;
+
+  //Declare a edgeList vector to save edges
+  std::vector< std::pair<uint64_t, uint64_t> > edgeList;
+
+  //Start adding the edges
+  if (c.rank() == 0) {
+
+    //First component (clique offset + 0-49)
+    for(uint64_t i = 0; i < 50 ; i++)
+      for(uint64_t j = 0; j < 50 ; j++)
+        if(i != j)
+          edgeList.emplace_back(offset + i, offset + j);
+
+    //Second component (chain offset + 100-101-...1000)
+    for(uint64_t i = 100; i < 1000 ; i++)
+    {
+      edgeList.emplace_back(offset + i, offset + i+1);
+      edgeList.emplace_back(offset + i+1, offset + i);
+    }
+  }
+
+  std::random_shuffle(edgeList.begin(), edgeList.end());
+
+  //Ids above 2^39 + 1000 do not leave the two reserved values free in 40 bits
+  if(c.rank() == 0)
+  {
+    std::vector< std::pair<uint64_t, uint64_t> > tooWide(1, std::make_pair(0UL, (1UL << 40) - 2));
+    std::vector< std::pair<conn::utils::uint40_t, conn::utils::uint40_t> > packedTooWide;
+    ASSERT_FALSE(conn::utils::packEdgeList(tooWide, packedTooWide));
+    ASSERT_EQ(1, tooWide.size());
+    ASSERT_EQ(0, packedTooWide.size());
+  }
+
+  std::vector< std::pair<conn::utils::uint48_t, conn::utils::uint48_t> > packedEdgeList;
+  ASSERT_TRUE(conn::utils::packEdgeList(edgeList, packedEdgeList));
+  ASSERT_EQ(12, sizeof(packedEdgeList[0]));
+
+  conn::coloring::ccl<conn::utils::uint48_t> cclInstance(packedEdgeList, c);
+  cclInstance.compute();
+  auto component_count = cclInstance.computeComponentCount();
+  ASSERT_EQ(2, component_count);
+
+  auto largest = cclInstance.computeLargestComponentSize();
+  ASSERT_EQ(50*49/2, largest);
+}
+
+/**
+ * @brief       coloring with the sorts bounded to a small memory budget
+ * @details     Three chains of length 300, with a budget of 4 KB per sort.
+ *              Test if program returns 3 as the component count
+ */
+TEST(connColoring, sortMemoryBudget) {
+
+  mxx::comm c = mxx::comm();
+
+  //Declare a edgeList vector to save edges
+  std::vector< std::pair<uint64_t, uint64_t> > edgeList;
+
+  //Start adding the edges
+  if (c.rank() == 0) {
+
+    //Chains 0-299, 1000-1299 and 2000-2299
+    for(int k = 0; k < 3 ; k++)
+      for(int i = 1000*k; i < 1000*k + 299 ; i++)
+      {
+        edgeList.emplace_back(i, i+1);
+        edgeList.emplace_back(i+1, i);
+      }
+  }
+
+  std::random_shuffle(edgeList.begin(), edgeList.end());
+  conn::coloring::ccl<> cclInstance(edgeList, c);
+  cclInstance.setSortMemoryBudget(4096);
+  cclInstance.compute();
+  auto component_count = cclInstance.computeComponentCount();
+  ASSERT_EQ(3, component_count);
+}
+
+/**
+ * @brief       bounded memory sort against mxx::sort
+ * @details     Unequal local sizes, rank 1 holds no elements, and only five keys so most of
+ *              the split boundaries fall within runs of keys equal across the ranks.
+ *              Test if findSplits() hands each rank its count, and if the sort keeps the local
+ *              counts, orders the keys as mxx::sort does and permutes the elements
+ */
+TEST(connColoring, boundedMemorySort) {
+
+  mxx::comm c = mxx::comm();
+
+  //<key, unique value> pairs, compared by the key only
+  std::vector< std::pair<uint64_t, uint64_t> > elements;
+
+  std::size_t localCount = c.rank() == 1 ? 0 : 40 + 37 * c.rank();
+  for(std::size_t i = 0; i < localCount; i++)
+    elements.emplace_back((i * 7 + c.rank()) % 5, 1000 * c.rank() + i);
+
+  auto cmp = conn::utils::TpleComp<0>();
+
+  //Split positions, each rank should receive its own count
+  {
+    auto sorted = elements;
+    std::sort(sorted.begin(), sorted.end(), cmp);
+
+    auto sizes = mxx::allgather(localCount, c);
+    std::vector<std::size_t> targets(c.size() - 1);
+    std::partial_sum(sizes.begin(), sizes.end() - 1, targets.begin());
+
+    auto splits = conn::utils::findSplits(sorted.begin(), sorted.end(), targets, cmp, c);
+    ASSERT_EQ(c.size() + 1, splits.size());
+
+    std::vector<std::size_t> sent(c.size());
+    for(int d = 0; d < c.size(); d++)
+    {
+      ASSERT_LE(splits[d], splits[d+1]);
+      sent[d] = splits[d+1] - splits[d];
+    }
+
+    ASSERT_EQ(sizes, mxx::allreduce(sent, std::plus<std::size_t>(), c));
+  }
+
+  auto reference = elements;
+  mxx::sort(reference.begin(), reference.end(), cmp, c);
+
+  //Budget of a few elements per round
+  conn::utils::boundedMemorySort(elements.begin(), elements.end(), cmp, 64, c);
+
+  ASSERT_EQ(localCount, elements.size());
+  ASSERT_TRUE(mxx::is_sorted(elements.begin(), elements.end(), cmp, c));
+
+  for(std::size_t i = 0; i < localCount; i++)
+    ASSERT_EQ(reference[i].first, elements[i].first);
+
+  //Every element is still present once
+  std::vector<uint64_t> values;
+  for(auto &e : elements)
+    values.push_back(e.second);
+
+  auto allValues = mxx::allgatherv(values, c);
+  std::sort(allValues.begin(), allValues.end());
+
+  std::vector<uint64_t> expected;
+  for(int r = 0; r < c.size(); r++)
+    for(std::size_t i = 0; i < (r == 1 ? 0 : 40 + 37 * r); i++)
+      expected.push_back(1000 * r + i);
+
+  ASSERT_EQ(expected, allValues);
+}
+
+/**
+ * @brief       coloring with the stable tuples kept compressed
+ * @details     Many small stars which stabilize early, and a long chain.
+ *              Test if the count, the largest size and the labels survive the compression
+ */
+TEST(connColoring, stableCompression) {
+
+  mxx::comm c = mxx::comm();
+
+  //Declare a edgeList vector to save edges
+  std::vector< std::pair<uint64_t, uint64_t> > edgeList;
+
+  //Start adding the edges
+  if (c.rank() == 0) {
+
+    //100 stars with 5 leaves each, vertices 0-599
+    for(int k = 0; k < 100 ; k++)
+      for(int i = 1; i <= 5 ; i++)
+      {
+        edgeList.emplace_back(6*k, 6*k + i);
+        edgeList.emplace_back(6*k + i, 6*k);
+      }
+
+    //Chain 1000-1999
+    for(int i = 1000; i < 1999 ; i++)
+    {
+      edgeList.emplace_back(i, i+1);
+      edgeList.emplace_back(i+1, i);
+    }
+  }
+
+  std::random_shuffle(edgeList.begin(), edgeList.end());
+  conn::coloring::ccl<> cclInstance(edgeList, c);
+  cclInstance.setStableCompression(true);
+  cclInstance.compute();
+
+  auto component_count = cclInstance.computeComponentCount();
+  ASSERT_EQ(101, component_count);
+
+  auto largest = cclInstance.computeLargestComponentSize();
+  ASSERT_EQ(999, largest);
+
+  std::vector< std::pair<uint64_t, uint64_t> > labels;
+  cclInstance.getVertexLabels(labels);
+
+  auto labelCount = mxx::allreduce(labels.size(), std::plus<std::size_t>(), c);
+  ASSERT_EQ(1600, labelCount);
+
+  //Each star is labeled by one of its own vertices
+  for(auto &l : labels)
+    if(l.first < 600)
+      ASSERT_EQ(l.first / 6, l.second / 6);
+}
+
+/**
+ * @brief       coloring over a chain generated lazily, in chunks of 100 edges
+ * @details     both ways and half-edge storage, with and without the id permutation.
+ *              Test if program returns 1 as the component count
+ */
+TEST(connColoring, implicitChain) {
+
+  mxx::comm c = mxx::comm();
+
+  using nodeIdType = int64_t;
+
+  {
+    conn::graphGen::UndirectedChainSource<nodeIdType> source(5000, c, true, 100);
+    conn::coloring::ccl<nodeIdType> cclInstance(source, c);
+    cclInstance.compute();
+    ASSERT_EQ(1, cclInstance.computeComponentCount());
+  }
+
+  {
+    conn::graphGen::UndirectedChainSource<nodeIdType> source(5000, c, false, 100);
+    conn::graphGen::permutedEdgeSource<decltype(source)> permuted(source);
+    conn::coloring::ccl<nodeIdType> cclInstance(permuted, c, conn::utils::memPlacement::firstTouch, conn::graphGen::edgeStorage::halfEdges);
+    cclInstance.compute();
+    ASSERT_EQ(1, cclInstance.computeComponentCount());
+  }
+}
+
+/**
+ * @brief       embedding API over caller owned arrays
+ * @details     Chains 0-99, 1000-1099 and 2000-2099, each undirected edge listed once,
+ *              as separate columns and as interleaved pairs.
+ *              Test the count, and that the edge labels tell the chains apart
+ */
+TEST(connColoring, embeddingApi) {
+
+  mxx::comm c = mxx::comm();
+
+  std::vector<int64_t> src, dst, interleaved;
+
+  if (c.rank() == 0) {
+    for(int k = 0; k < 3 ; k++)
+      for(int i = 1000*k; i < 1000*k + 99 ; i++)
+      {
+        src.push_back(i);
+        dst.push_back(i+1);
+        interleaved.push_back(i+1);
+        interleaved.push_back(i);
+      }
+  }
+
+  std::vector<int64_t> labels(src.size());
+  auto component_count = conn::coloring::computeComponents(src.data(), dst.data(), src.size(), labels.data(), c);
+  ASSERT_EQ(3, component_count);
+
+  for(std::size_t i = 0; i < src.size(); i++)
+  {
+    ASSERT_EQ(src[i] / 1000, labels[i] / 1000);
+    ASSERT_EQ(labels[i - i % 99], labels[i]);
+  }
+
+  std::vector<int64_t> labels2(interleaved.size() / 2);
+  component_count = conn::coloring::computeComponents(interleaved.data(), labels2.size(), labels2.data(), c);
+  ASSERT_EQ(3, component_count);
+  ASSERT_TRUE(labels == labels2);
+
+  //Count only
+  component_count = conn::coloring::computeComponents(src.data(), dst.data(), src.size(), (int64_t *) nullptr, c);
+  ASSERT_EQ(3, component_count);
+}
+
+/**
+ * @brief       settings chosen by the memory planner
+ * @details     Chain of 1000 edges stored both ways, 2000 pairs of 16 bytes on rank 0.
+ *              Estimates are 32000 bytes for the edge list, 96000 for BFS and 96000 for
+ *              coloring, 82000 once the ids are packed in 5 bytes
+ */
+TEST(connColoring, memoryPlanner) {
+
+  mxx::comm c = mxx::comm();
+
+  //Declare a edgeList vector to save edges
+  std::vector< std::pair<uint64_t, uint64_t> > edgeList;
+
+  //Start adding the edges
+  if (c.rank() == 0) {
+    for(int i = 0; i < 1000 ; i++)
+    {
+      edgeList.emplace_back(i, i+1);
+      edgeList.emplace_back(i+1, i);
+    }
+  }
+
+  //Everything fits
+  auto plan = conn::dynamic::planExecution(edgeList, true, 1UL << 30, c);
+  ASSERT_TRUE(plan.fits);
+  ASSERT_TRUE(plan.runBFS);
+  ASSERT_FALSE(plan.packedIds);
+  ASSERT_EQ(0, plan.sortBudget);
+
+  //BFS is dropped, and the ids are packed
+  plan = conn::dynamic::planExecution(edgeList, true, 90000, c);
+  ASSERT_TRUE(plan.fits);
+  ASSERT_FALSE(plan.runBFS);
+  ASSERT_TRUE(plan.packedIds);
+  ASSERT_EQ(0, plan.sortBudget);
+  ASSERT_EQ(82000, plan.peakBytes);
+
+  //Edge list and tuples together exceed the budget, whatever the sort
+  //The sort gets the 40000 bytes left next to the 30000 bytes of packed tuples,
+  //or the smallest budget of a bounded memory sort on many ranks
+  plan = conn::dynamic::planExecution(edgeList, true, 70000, c);
+  ASSERT_FALSE(plan.fits);
+  ASSERT_TRUE(plan.feasible);
+  ASSERT_TRUE(plan.compressStable);
+  ASSERT_EQ(std::max<std::size_t>(40000, conn::dynamic::minSortBudget(15, c)), plan.sortBudget);
+
+  //Remaining memory is below the smallest budget of a bounded memory sort
+  plan = conn::dynamic::planExecution(edgeList, true, 35000, c);
+  ASSERT_FALSE(plan.fits);
+  ASSERT_TRUE(plan.feasible);
+  ASSERT_EQ(conn::dynamic::minSortBudget(15, c), plan.sortBudget);
+
+  //Tuples alone exceed the budget, no sort can run within it
+  plan = conn::dynamic::planExecution(edgeList, true, 20000, c);
+  ASSERT_FALSE(plan.fits);
+  ASSERT_FALSE(plan.feasible);
+  ASSERT_EQ(0, plan.sortBudget);
+
+  //Linear algebraic CC keeps the BFS matrix, no coloring setting applies
+  plan = conn::dynamic::planExecution(edgeList, false, 90000, c, conn::graphGen::edgeStorage::bothWays, true);
+  ASSERT_FALSE(plan.fits);
+  ASSERT_TRUE(plan.feasible);
+  ASSERT_FALSE(plan.packedIds);
+  ASSERT_EQ(0, plan.sortBudget);
+  ASSERT_EQ(96000, plan.peakBytes);
+
+  plan = conn::dynamic::planExecution(edgeList, false, 100000, c, conn::graphGen::edgeStorage::bothWays, true);
+  ASSERT_TRUE(plan.fits);
+}
+
+/**
+ * @brief       connectivity of a batch of graphs in one run
+ * @details     graph 0 is a chain, graph 1 two chains and graph 2 three 
+ *              disjoint edges, all using the same vertex ids.
+ *              Test if program returns 1, 2 and 3 as the component counts,
+ *              and the minimum vertex id of each component as its label
+ */
+TEST(connColoring, batchOfGraphs) {
+
+  mxx::comm c = mxx::comm();
+
+  //Declare a edgeList vector to save <graph, src, dst> edges
+  std::vector< std::tuple<uint64_t, uint64_t, uint64_t> > edgeList;
+
+  auto addEdge = [&](uint64_t g, uint64_t u, uint64_t v){
+    edgeList.emplace_back(g, u, v);
+    edgeList.emplace_back(g, v, u);
+  };
+
+  //Start adding the edges
+  if (c.rank() == 0) {
+
+    //Graph 0 (chain 0-1-...99)
+    for(int i = 0; i < 99 ; i++)
+      addEdge(0, i, i+1);
+
+    //Graph 1 (chains 0-...49 and 50-...99)
+    for(int i = 0; i < 99 ; i++)
+      if(i != 49)
+        addEdge(1, i, i+1);
+
+    //Graph 2 (edges 0-1, 2-3, 4-5)
+    for(int i = 0; i < 6 ; i += 2)
+      addEdge(2, i, i+1);
+  }
+
+  std::random_shuffle(edgeList.begin(), edgeList.end());
+  conn::coloring::batchCcl<> batchInstance(edgeList, 3, c);
+  batchInstance.compute();
+
+  auto counts = batchInstance.computeComponentCounts();
+  std::vector<std::size_t> expected = {1, 2, 3};
+  ASSERT_EQ(expected, counts);
+
+  //Labels stay within their graph, each component is labeled by its minimum vertex id
+  std::vector< std::tuple<uint64_t, uint64_t, uint64_t> > labels;
+  batchInstance.getVertexLabels(labels);
+
+  for(auto &l : labels)
+  {
+    if(std::get<0>(l) == 0)
+      ASSERT_EQ(0, std::get<2>(l));
+    if(std::get<0>(l) == 1)
+      ASSERT_EQ(std::get<1>(l) / 50 * 50, std::get<2>(l));
+    if(std::get<0>(l) == 2)
+      ASSERT_EQ(std::get<1>(l) / 2 * 2, std::get<2>(l));
+  }
+
+  std::size_t labelCount = mxx::allreduce(labels.size(), std::plus<std::size_t>(), c);
+  ASSERT_EQ(206, labelCount);
+}
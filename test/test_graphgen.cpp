@@ -29,8 +29,11 @@
 //Own includes
 #include "utils/commonfuncs.hpp"
 #include "graphGen/common/reduceIds.hpp"
+#include "graphGen/common/reorderIds.hpp"
+#include "graphGen/common/partitionGraph.hpp"
 #include "graphGen/graph500/graph500Gen.hpp"
 #include "graphGen/fileIO/graphReader.hpp"
+#include "graphGen/fileIO/edgeStream.hpp"
 
 //External includes
 #include "extutils/logging.hpp"
@@ -105,3 +108,345 @@ TEST(graphGen, graphFileIO) {
 
   }
 }
+
+/*
+ * @brief   Same graph as graphFileIO, read through two aggregator ranks per node
+ *          in blocks of 4 KB, smaller than the file
+ */
+TEST(graphGen, graphFileIOAggregated) {
+
+  mxx::comm comm = mxx::comm();
+
+  std::string fileName = PROJECT_TEST_DATA_FOLDER;
+  fileName = fileName + "/graphDirChain.txt";
+
+  using vertexIdType = int64_t;
+
+  std::vector< std::pair<vertexIdType, vertexIdType> > edgeList;
+
+  {
+    conn::graphGen::GraphFileParser<char *, vertexIdType> g(edgeList, true, fileName, comm);
+
+    g.populateEdgeListAggregated(2, 4096);
+  }
+
+  //Gather complete edgeList on rank 0
+  auto fullEdgeList = mxx::gatherv(edgeList, 0, comm);
+
+  if(!comm.rank())
+  {
+    const int SRC = 0, DEST = 1;
+    std::sort(fullEdgeList.begin(), fullEdgeList.end(), conn::utils::TpleComp2Layers<SRC, DEST>());
+
+    ASSERT_EQ(fullEdgeList.size(), 2400);
+
+    //1-2, 2-1, 2-3, 3-2 ... 1200-1201, 1201-1200
+    for(int i = 0; i < fullEdgeList.size(); i += 2)
+    {
+      ASSERT_EQ(fullEdgeList[i].first, i/2 + 1);
+      ASSERT_EQ(fullEdgeList[i].second, i/2 + 2);
+      ASSERT_EQ(fullEdgeList[i+1].first, i/2 + 2);
+      ASSERT_EQ(fullEdgeList[i+1].second, i/2 + 1);
+    }
+  }
+}
+
+/*
+ * @brief   Same graph as graphFileIO, streamed sequentially by rank 0
+ *          in batches of 100 edges
+ */
+TEST(graphGen, edgeStream) {
+
+  mxx::comm comm = mxx::comm();
+
+  std::string fileName = PROJECT_TEST_DATA_FOLDER;
+  fileName = fileName + "/graphDirChain.txt";
+
+  using vertexIdType = int64_t;
+
+  std::vector< std::pair<vertexIdType, vertexIdType> > edgeList;
+
+  {
+    std::vector<std::string> sources(1, fileName);
+    conn::graphGen::EdgeStreamParser<vertexIdType> g(edgeList, true, sources, comm, 100);
+
+    g.populateEdgeList();
+  }
+
+  //Gather complete edgeList on rank 0
+  auto fullEdgeList = mxx::gatherv(edgeList, 0, comm);
+
+  if(!comm.rank())
+  {
+    const int SRC = 0, DEST = 1;
+    std::sort(fullEdgeList.begin(), fullEdgeList.end(), conn::utils::TpleComp2Layers<SRC, DEST>());
+
+    ASSERT_EQ(fullEdgeList.size(), 2400);
+
+    //1-2, 2-1, 2-3, 3-2 ... 1200-1201, 1201-1200
+    for(int i = 0; i < fullEdgeList.size(); i += 2)
+    {
+      ASSERT_EQ(fullEdgeList[i].first, i/2 + 1);
+      ASSERT_EQ(fullEdgeList[i].second, i/2 + 2);
+      ASSERT_EQ(fullEdgeList[i+1].first, i/2 + 2);
+      ASSERT_EQ(fullEdgeList[i+1].second, i/2 + 1);
+    }
+  }
+}
+
+/*
+ * @brief   Kronecker edges generated lazily, in chunks of about 1000 edges
+ *          and in a single chunk. Both should give the same edges, within
+ *          the size hint, and the degree sequence of Graph500Gen, which
+ *          only permutes the vertex ids and the edges on top
+ */
+TEST(graphGen, graph500Source) {
+
+  mxx::comm comm = mxx::comm();
+
+  using vertexIdType = int64_t;
+
+  const int scale = 10;
+
+  auto pullEdges = [&](std::size_t chunkEdges, std::size_t &chunks)
+  {
+    conn::graphGen::Graph500Source source(scale, 16, comm, false, chunkEdges);
+
+    std::vector< std::pair<vertexIdType, vertexIdType> > edgeList, chunk;
+    chunks = 0;
+
+    while(source.next(chunk))
+    {
+      edgeList.insert(edgeList.end(), chunk.begin(), chunk.end());
+      chunks++;
+    }
+
+    EXPECT_LE(edgeList.size(), source.sizeHint());
+
+    return mxx::gatherv(edgeList, 0, comm);
+  };
+
+  std::size_t smallChunks, largeChunks;
+  auto chunkedEdges = pullEdges(1000, smallChunks);
+  auto wholeEdges = pullEdges(1UL << 20, largeChunks);
+
+  ASSERT_LT(largeChunks, smallChunks);
+
+  std::vector< std::pair<vertexIdType, vertexIdType> > edgeList;
+  conn::graphGen::Graph500Gen g;
+  g.populateEdgeList(edgeList, scale, 16, comm, false);
+
+  auto generatedEdges = mxx::gatherv(edgeList, 0, comm);
+
+  if(!comm.rank())
+  {
+    const int SRC = 0, DEST = 1;
+    std::sort(chunkedEdges.begin(), chunkedEdges.end(), conn::utils::TpleComp2Layers<SRC, DEST>());
+    std::sort(wholeEdges.begin(), wholeEdges.end(), conn::utils::TpleComp2Layers<SRC, DEST>());
+
+    ASSERT_EQ(wholeEdges, chunkedEdges);
+    ASSERT_EQ(generatedEdges.size(), chunkedEdges.size());
+
+    //Sorted degree sequences, vertex ids are permuted in Graph500Gen
+    auto degreeSequence = [&](const std::vector< std::pair<vertexIdType, vertexIdType> > &edges)
+    {
+      std::vector<std::size_t> degrees(1UL << scale, 0);
+      for(auto &e : edges)
+      {
+        degrees[e.first]++;
+        degrees[e.second]++;
+      }
+
+      std::sort(degrees.begin(), degrees.end());
+      return degrees;
+    };
+
+    ASSERT_EQ(degreeSequence(generatedEdges), degreeSequence(chunkedEdges));
+  }
+}
+
+/*
+ * @brief   Test the removal of self loops and duplicate edges
+ *          Each rank inserts the chain {0-1-2...99} three times along 
+ *          with self loops on every vertex, we expect 99*2 edges to 
+ *          remain in total
+ */
+TEST(graphGen, removeDuplicateEdges) {
+
+  mxx::comm comm = mxx::comm();
+
+  using vertexIdType = int64_t;
+
+  std::vector< std::pair<vertexIdType, vertexIdType> > edgeList;
+
+  for(int copy = 0; copy < 3; copy++)
+    for(int i = 0; i < 99; i++)
+    {
+      edgeList.emplace_back(i, i+1);
+      edgeList.emplace_back(i+1, i);
+      edgeList.emplace_back(i, i);
+    }
+
+  auto removed = conn::graphGen::removeDuplicateEdges(edgeList, comm);
+
+  auto leftEdgesCount = conn::graphGen::globalSizeOfVector(edgeList, comm);
+
+  ASSERT_EQ(leftEdgesCount, 99*2);
+  ASSERT_EQ(removed, 99*9*comm.size() - 99*2);
+}
+
+/*
+ * @brief   Test the id compaction of an edge list with each edge stored once
+ *          Rank r inserts the chain {0-10-20...990} shifted by 1000*r, with the
+ *          edges in alternating directions, so some vertices occur only as a 
+ *          destination. Ids should become [0, 100p), and the chains intact
+ */
+TEST(graphGen, reduceVertexIdsHalfEdges) {
+
+  mxx::comm comm = mxx::comm();
+
+  using vertexIdType = int64_t;
+
+  std::vector< std::pair<vertexIdType, vertexIdType> > edgeList;
+
+  vertexIdType offset = 1000 * comm.rank();
+
+  for(int i = 0; i < 99; i++)
+  {
+    if(i % 2)
+      edgeList.emplace_back(offset + 10*i, offset + 10*(i+1));
+    else
+      edgeList.emplace_back(offset + 10*(i+1), offset + 10*i);
+  }
+
+  std::size_t nVertices;
+  conn::graphGen::reduceVertexIds(edgeList, nVertices, comm, conn::graphGen::edgeStorage::halfEdges);
+
+  ASSERT_EQ(nVertices, 100 * comm.size());
+  ASSERT_EQ(conn::graphGen::globalSizeOfVector(edgeList, comm), 99 * comm.size());
+
+  //Consecutive vertices of a chain have consecutive ids
+  for(auto &e : edgeList)
+  {
+    ASSERT_TRUE(e.first >= 0 && e.first < (vertexIdType) nVertices);
+    ASSERT_EQ(std::abs(e.first - e.second), 1);
+    ASSERT_EQ(e.first / 100, e.second / 100);
+  }
+
+  //Every vertex is present
+  std::vector<vertexIdType> vertices;
+  for(auto &e : edgeList)
+  {
+    vertices.push_back(e.first);
+    vertices.push_back(e.second);
+  }
+
+  auto allVertices = mxx::allgatherv(vertices, comm);
+  std::sort(allVertices.begin(), allVertices.end());
+  allVertices.erase(std::unique(allVertices.begin(), allVertices.end()), allVertices.end());
+
+  ASSERT_EQ(allVertices.size(), nVertices);
+}
+
+/*
+ * @brief   Test the locality reordering of vertex ids
+ *          Graph has 10 cliques of size 10, vertex i belongs to clique 
+ *          (i % 10). After reordering, each clique should occupy a 
+ *          contiguous range of 10 ids
+ */
+TEST(graphGen, reorderVertexIds) {
+
+  mxx::comm comm = mxx::comm();
+
+  using vertexIdType = int64_t;
+
+  std::vector< std::pair<vertexIdType, vertexIdType> > edgeList;
+
+  if(!comm.rank())
+    for(int i = 0; i < 100; i++)
+      for(int j = 0; j < 100; j++)
+        if(i != j && i % 10 == j % 10)
+          edgeList.emplace_back(i, j);
+
+  mxx::distribute_inplace(edgeList, comm);
+
+  std::size_t nVertices;
+  conn::graphGen::reduceVertexIds(edgeList, nVertices, comm);
+  conn::graphGen::reorderVertexIds(edgeList, nVertices, comm);
+
+  ASSERT_EQ(nVertices, 100);
+  ASSERT_EQ(conn::graphGen::globalSizeOfVector(edgeList, comm), 100*9);
+
+  for(auto &e : edgeList)
+  {
+    ASSERT_TRUE(e.first >= 0 && e.first < 100);
+    ASSERT_EQ(e.first / 10, e.second / 10);
+  }
+}
+
+/*
+ * @brief   Test the size constrained partitioning of the vertices
+ *          Graph has 10p cliques of size 10, vertex i belongs to clique 
+ *          (i % 10p), so the block ids cut most of the edges. The new ids 
+ *          should be a permutation of [0, 100p), each edge should be on the 
+ *          owner of its source, the edges within the imbalance bound, and
+ *          fewer edges cut by the returned ranges than by the block ids
+ */
+TEST(graphGen, partitionVertices) {
+
+  mxx::comm comm = mxx::comm();
+
+  using vertexIdType = int64_t;
+
+  std::vector< std::pair<vertexIdType, vertexIdType> > edgeList;
+
+  int nCliques = 10 * comm.size();
+  std::size_t nVertices = 10 * nCliques;
+
+  //Rank r lists the edges of the vertices [100r, 100r + 100)
+  for(std::size_t u = 100 * comm.rank(); u < 100 * (comm.rank() + 1); u++)
+    for(std::size_t v = u % nCliques; v < nVertices; v += nCliques)
+      if(u != v)
+        edgeList.emplace_back(u, v);
+
+  double epsilon = 0.05;
+
+  double cutBefore = conn::graphGen::cutEdgeFraction(edgeList, nVertices, comm);
+  auto vertexRanges = conn::graphGen::partitionVertices(edgeList, nVertices, comm, conn::graphGen::edgeStorage::bothWays, epsilon);
+
+  ASSERT_EQ(vertexRanges.size(), comm.size());
+  ASSERT_EQ(std::accumulate(vertexRanges.begin(), vertexRanges.end(), (std::size_t) 0), nVertices);
+
+  conn::utils::rangePartition part(vertexRanges, comm);
+
+  std::size_t totalEdges = conn::graphGen::globalSizeOfVector(edgeList, comm);
+  ASSERT_EQ(totalEdges, nVertices * 9);
+
+  //Edges on the owner of their source
+  for(auto &e : edgeList)
+    ASSERT_EQ(part.target_processor(e.first), comm.rank());
+
+  //Each part holds at most (1 + epsilon) * mean edges, see the capacity in partitionVertices
+  std::size_t maxEdges = mxx::allreduce(edgeList.size(), mxx::max<std::size_t>(), comm);
+  ASSERT_LE(maxEdges, (1.0 + epsilon) * totalEdges / comm.size() + 1);
+
+  //Ids are a permutation, and the cliques stay intact
+  std::vector<vertexIdType> sources;
+  for(auto &e : edgeList)
+    sources.push_back(e.first);
+
+  auto allSources = mxx::allgatherv(sources, comm);
+  std::sort(allSources.begin(), allSources.end());
+  allSources.erase(std::unique(allSources.begin(), allSources.end()), allSources.end());
+
+  ASSERT_EQ(allSources.size(), nVertices);
+  ASSERT_EQ(allSources.front(), 0);
+  ASSERT_EQ(allSources.back(), (vertexIdType) nVertices - 1);
+
+  double cutAfter = conn::graphGen::cutEdgeFraction(edgeList, part, comm);
+
+  if(comm.size() > 1)
+    ASSERT_LT(cutAfter, cutBefore);
+  else
+    ASSERT_EQ(cutAfter, 0.0);
+}